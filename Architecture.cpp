@@ -1,8 +1,10 @@
 #include "Architecture.hpp"
 #include "infra/Config.hpp"
 #include "infra/Math.hpp"
-#include <numeric>
+#include <algorithm>
 #include <iomanip>
+#include <limits>
+#include <numeric>
 //--------------------------------------------------------------------------------
 using namespace std;
 using namespace infra;
@@ -20,24 +22,42 @@ string archTypeToName(ArchType t) {
   unreachable();
 }
 //--------------------------------------------------------------------------------
-struct PairHasher {
-  size_t operator()(auto v) const { return multihash(v.first, v.second); }
-};
-static std::unordered_map<pair<uint64_t, double>, double, PairHasher> dpTable;
+thread_local Rejection lastRejection = Rejection::Other;
 //--------------------------------------------------------------------------------
-double cacheHarmonic(uint64_t i, double alpha) {
-  auto it = dpTable.find(pair(i,alpha));
-  if (it != dpTable.end()) {
-     return it->second;
-  } else {
-     double v = getGeneralizedHarmonicNumber(i, alpha);
-     dpTable.insert({pair(i, alpha), v});
-     return v;
+string rejectionToName(Rejection r) {
+  switch (r) {
+     case Rejection::Other: return "other";
+     case Rejection::CPUOps: return "cpuOps";
+     case Rejection::NetworkWrite: return "networkWrite";
+     case Rejection::NetworkRead: return "networkRead";
+     case Rejection::Memory: return "memory";
+     case Rejection::InstanceStorage: return "instanceStorage";
+     case Rejection::StorageSize: return "storageSize";
+     case Rejection::StorageIOPS: return "storageIops";
+     case Rejection::EBSLimits: return "ebsLimits";
+     case Rejection::EBSDevices: return "ebsDevices";
+     case Rejection::LogServiceScale: return "logServiceScale";
+     case Rejection::Durability: return "durability";
+     case Rejection::Latency: return "latency";
   }
+  unreachable();
+}
+//--------------------------------------------------------------------------------
+string resourceToName(Resource r) {
+  switch (r) {
+     case Resource::CPU: return "cpu";
+     case Resource::NetworkIn: return "net-in";
+     case Resource::NetworkOut: return "net-out";
+     case Resource::InstanceStorageIOPS: return "nvme-iops";
+     case Resource::EBS: return "ebs";
+     case Resource::LogService: return "log-svc";
+     case Resource::PageService: return "page-svc";
+  }
+  unreachable();
 }
 //--------------------------------------------------------------------------------
 double getAccumulatedZipf(uint64_t k, uint64_t N, double alpha) {
-  return cacheHarmonic(k, alpha) / cacheHarmonic(N, alpha);
+  return getGeneralizedHarmonicNumber(k, alpha) / getGeneralizedHarmonicNumber(N, alpha);
 }
 //--------------------------------------------------------------------------------
 string Primary::getDescription() const {
@@ -56,13 +76,13 @@ Primary::Primary(const Parameter& p, const Node& n, bool rbpex) : p{p}, n{n}, us
   if (p.lookupZipf != 0.0) {
      assert(p.indexOnlyTables); // Not implemented yet
      assert(p.requiredUpdateOps.rate == 0);
-     auto cacheGB = dataInCache() / 1024 / 1024 / 1024;
-     auto firstCacheGB = dataInFirstCache() / 1024 / 1024 / 1024;
-     //     auto secondCacheGB = dataInSecondCache() / 1024 / 1024 / 1024;
-     auto datasetGB = p.getDataSize() / 1024 / 1024 / 1024;
-     probCacheHitVal = getAccumulatedZipf(cacheGB, datasetGB, p.lookupZipf);
-     probFirstCacheHitVal = getAccumulatedZipf(firstCacheGB, datasetGB, p.lookupZipf);
-     //     probSecondCacheHitVal = getAccumulatedZipf(secondCacheGB, datasetGB, p.lookupZipf);
+     probIndexCacheHitVal = 1.0; // Index-only tables
+     // Page granularity, the harmonic numbers are evaluated in closed form
+     auto cachePages = dataInCache() / p.pageSize;
+     auto firstCachePages = dataInFirstCache() / p.pageSize;
+     auto datasetPages = p.getDataSize() / p.pageSize;
+     probCacheHitVal = getAccumulatedZipf(cachePages, datasetPages, p.lookupZipf);
+     probFirstCacheHitVal = getAccumulatedZipf(firstCachePages, datasetPages, p.lookupZipf);
      probSecondCacheHitVal = probCacheHitVal - probFirstCacheHitVal;
      //     assert(probFirstCacheHitVal + probSecondCacheHitVal == probCacheHitVal);
   } else {
@@ -98,9 +118,9 @@ optional<EBSAllotment> Primary::addEBSCapacity(EBS::Type t, uint64_t size, Rate
      }
    }
 
-   if (totalIops > n.machineEbs.baseIops) return {};
-   if (totalThroughput > n.machineEbs.baseThroughput) return {};
-   if (totalDevices > n.maxEBSDevices()) return {};
+   if (totalIops > n.machineEbs.baseIops) return reject(Rejection::EBSLimits);
+   if (totalThroughput > n.machineEbs.baseThroughput) return reject(Rejection::EBSLimits);
+   if (totalDevices > n.maxEBSDevices()) return reject(Rejection::EBSDevices);
 
    auto& allot = ebsReserved[static_cast<unsigned>(t)];
    allot.size += size;
@@ -125,7 +145,14 @@ Rate Primary::getCacheHitOps(Rate alreadyUsed) const {
 unique_ptr<Primary> Primary::assemble(const Parameter& p, const Node& n, bool rbpex) {
   auto res = make_unique<Primary>(p,n,rbpex);
   auto ops = p.requiredOpsPerNode();
-  if (res->getCacheHitOps() < ops) return nullptr;
+  if (res->getCacheHitOps() < ops) return reject(Rejection::CPUOps);
+  return res;
+}
+//--------------------------------------------------------------------------------
+unique_ptr<Primary> Primary::assemble(const Parameter& p, const Primary& prototype) {
+  auto res = make_unique<Primary>(prototype, p);
+  auto ops = p.requiredOpsPerNode();
+  if (res->getCacheHitOps() < ops) return reject(Rejection::CPUOps);
   return res;
 }
 //--------------------------------------------------------------------------------
@@ -146,6 +173,96 @@ Price Architecture::getTotalPriceImpl() const {
   return price;
 }
 //--------------------------------------------------------------------------------
+void Architecture::setUtilization(Resource r, Rate demand, Rate capacity) {
+  if (demand == Rate::zero) return;
+  auto& u = utilization[static_cast<uint8_t>(r)];
+  auto v = (capacity == Rate::zero) ? numeric_limits<double>::infinity() : demand / capacity;
+  if (v >= u) {
+     u = v;
+     this->capacity[static_cast<uint8_t>(r)] = capacity.rate;
+  }
+}
+//--------------------------------------------------------------------------------
+void Architecture::setEBSUtilization() {
+  auto& prim = getPrimary();
+  Rate iops = Rate::zero;
+  uint64_t bandwidth = 0;
+  for (auto& allot : prim.ebsReserved) {
+     iops += allot.iops;
+     bandwidth += allot.bandwidth;
+  }
+  // The volumes can be provisioned with more IOPS, up to the limits of the machine
+  setUtilization(Resource::EBS, iops, prim.n.machineEbs.baseIops);
+  setUtilization(Resource::EBS, Rate::secondly(bandwidth), Rate::secondly(prim.n.machineEbs.baseThroughput));
+}
+//--------------------------------------------------------------------------------
+Latency Architecture::getQueueingDelay(Resource r, Latency serviceTime) const {
+  auto u = getUtilization(r);
+  auto c = capacity[static_cast<uint8_t>(r)];
+  if (u == 0.0 || c == 0.0) return Latency{0ns};
+  switch (r) {
+     case Resource::CPU: {
+        // Every core serves its share of the operations
+        double cores = getPrimary().n.cpu.count;
+        return Latency::queueing(u, cores, duration<double>(cores / c), false);
+     }
+     case Resource::NetworkIn:
+     case Resource::NetworkOut:
+        // The link transfers the pages and log records one after the other
+        return Latency::queueing(u, 1, duration<double>(1 / c), true);
+     case Resource::EBS: {
+        // The utilization may stem from the throughput, the outstanding requests are bounded by the iops
+        auto iops = getPrimary().n.machineEbs.baseIops;
+        return Latency::queueing(u, iops.rate * duration<double>(serviceTime.avg).count(), serviceTime.avg, true);
+     }
+     case Resource::InstanceStorageIOPS:
+        return Latency::queueing(u, c * duration<double>(serviceTime.avg).count(), serviceTime.avg, true);
+     case Resource::LogService:
+     case Resource::PageService:
+        return Latency::queueing(u, c * duration<double>(serviceTime.avg).count(), serviceTime.avg, false);
+  }
+  unreachable();
+}
+//--------------------------------------------------------------------------------
+void Architecture::addQueueingDelays(initializer_list<tuple<double, Resource, Latency>> opPath, initializer_list<pair<Resource, Latency>> commitPath) {
+  if (!parameter.queueingLatency) return;
+  // A saturated resource never drains its queue
+  auto saturated = [](const Latency& l) { return l.avg >= Latency::infinite().avg; };
+  auto opDelay = getQueueingDelay(Resource::CPU);
+  for (auto& [fraction, r, serviceTime] : opPath) {
+     if (fraction == 0.0) continue;
+     auto delay = getQueueingDelay(r, serviceTime);
+     if (saturated(delay)) opDelay = delay;
+     if (saturated(opDelay)) break;
+     opDelay = opDelay + Latency{0ns, duration_cast<nanoseconds>(fraction * duration<double>(delay.avg)), delay.max};
+  }
+  auto commitDelay = Latency{0ns};
+  for (auto& [r, serviceTime] : commitPath) {
+     auto delay = getQueueingDelay(r, serviceTime);
+     commitDelay = saturated(delay) ? delay : commitDelay + delay;
+     if (saturated(commitDelay)) break;
+  }
+  opLatency = saturated(opDelay) ? Latency::infinite() : opLatency + opDelay;
+  // Without updates there are no commits to wait for
+  if (parameter.requiredUpdateOps != Rate::zero) commitLatency = saturated(commitDelay) ? Latency::infinite() : commitLatency + commitDelay;
+}
+//--------------------------------------------------------------------------------
+Resource Architecture::getBottleneck() const {
+  // The page service is excluded, it is the last resource
+  auto it = max_element(utilization.begin(), utilization.begin() + static_cast<uint8_t>(Resource::PageService));
+  return static_cast<Resource>(it - utilization.begin());
+}
+//--------------------------------------------------------------------------------
+double Architecture::getHeadroom() const {
+  auto u = getUtilization(getBottleneck());
+  return (u == 0.0) ? numeric_limits<double>::infinity() : 1.0 / u;
+}
+//--------------------------------------------------------------------------------
+Rate Architecture::getMaxTransactions() const {
+  auto headroom = getHeadroom();
+  return isinf(headroom) ? Rate::unlimited : parameter.requiredOps() * headroom;
+}
+//--------------------------------------------------------------------------------
 static Price getS3StorageCost(const Architecture& a) {
   auto size = a.getS3Storage();
 
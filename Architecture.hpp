@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <set>
+#include <tuple>
 #include <unordered_set>
 #include <variant>
 #include <cassert>
@@ -25,9 +26,55 @@ enum class ArchType : uint8_t {
 //--------------------------------------------------------------------------------
 std::string archTypeToName(ArchType);
 //--------------------------------------------------------------------------------
+/// Why the model could not build an architecture from a candidate, counted by --stats
+enum class Rejection : uint8_t {
+   Other,
+   CPUOps,
+   NetworkWrite,
+   NetworkRead,
+   Memory,
+   InstanceStorage, // The node lacks the instance storage the design needs
+   StorageSize,
+   StorageIOPS,
+   EBSLimits, // The EBS IOPS or throughput of the machine
+   EBSDevices,
+   LogServiceScale, // The log service would need more than one log node
+   Durability,
+   Latency
+};
+constexpr unsigned numRejections = 13;
+std::string rejectionToName(Rejection);
+/// The reason of the last rejection on this thread, the builder reads it right after an assemble call failed
+extern thread_local Rejection lastRejection;
+/// Converts to an empty unique_ptr or optional, so that `return reject(Rejection::CPUOps);` records why a model function failed
+struct Rejected {
+   template <typename T>
+   operator std::unique_ptr<T>() const { return nullptr; }
+   template <typename T>
+   operator std::optional<T>() const { return std::nullopt; }
+};
+inline Rejected reject(Rejection reason) {
+   lastRejection = reason;
+   return {};
+}
+//--------------------------------------------------------------------------------
+/// The resources whose capacity bounds the throughput of an architecture
+enum class Resource : uint8_t {
+   CPU,
+   NetworkIn, // Of the primary
+   NetworkOut,
+   InstanceStorageIOPS, // The busier of the reads and the writes
+   EBS, // The EBS IOPS or throughput limit of the primary, whichever is closer
+   LogService, // A log service on a separate node
+   PageService // Relative to the purchased share of the page servers, which grows with the workload, so it is never the bottleneck
+};
+constexpr unsigned numResources = 7;
+std::string resourceToName(Resource);
+//--------------------------------------------------------------------------------
 struct Primary {
    Parameter p;
-   Node n;
+   /// Refers to the node catalog of the builder, which outlives all architectures
+   const Node& n;
    std::array<std::optional<EBS>, 4> ebs;
    std::array<EBSAllotment, 4> ebsReserved;
    std::optional<EBS>& getEBS(EBS::Type t) { return ebs[static_cast<unsigned>(t)]; }
@@ -47,7 +94,11 @@ struct Primary {
 
    Primary(const Parameter& p, const Node& n, bool rbpex = false);
    static std::unique_ptr<Primary> assemble(const Parameter& p, const Node& n, bool rbpex = false);
+   static std::unique_ptr<Primary> assemble(const Parameter& p, const Primary& prototype);
    Primary(const Primary& p) = default;
+   /// Copy a prototype for different parameters. The cache hit probabilities only depend on the node and on parameters that are fixed for a run,
+   /// not on the number of secondaries or the log record format, so they do not need to be derived again.
+   Primary(const Primary& prototype, const Parameter& p) : Primary{prototype} { this->p = p; }
    std::string getDescription() const;
    Price getEBSPrice() const {
       Price result = Price::zero;
@@ -63,11 +114,11 @@ struct Primary {
    std::optional<EBSAllotment> addEBSCapacity(EBS::Type t, uint64_t size, Rate iops, uint64_t bandwidth, uint64_t iopSize);
 
    std::optional<InstanceStorageAllotment> reserveInstanceStorage(uint64_t size, Rate reads, Rate writes) {
-      if (usesBufferPoolExtension) return std::nullopt;
+      if (usesBufferPoolExtension) return reject(Rejection::InstanceStorage);
       //      if (!n.instanceStorage && (size != 0 || reads != Rate::zero || writes != Rate::zero)) return std::nullopt;
-      if (reserved.size + size > n.instanceStorage.getUsableSize()) return std::nullopt;
-      if (reserved.reads + reads > n.instanceStorage.getReadOps()) return std::nullopt;
-      if (reserved.writes + writes > n.instanceStorage.getWriteOps()) return std::nullopt;
+      if (reserved.size + size > n.instanceStorage.getUsableSize()) return reject(Rejection::StorageSize);
+      if (reserved.reads + reads > n.instanceStorage.getReadOps()) return reject(Rejection::StorageIOPS);
+      if (reserved.writes + writes > n.instanceStorage.getWriteOps()) return reject(Rejection::StorageIOPS);
       reserved.size += size;
       reserved.reads += reads;
       reserved.writes += writes;
@@ -117,12 +168,22 @@ struct Primary {
    // }
 };
 //--------------------------------------------------------------------------------
+/// The primaries of one node with and without buffer pool extension, derived once per run and copied for every candidate
+struct PrimaryPrototype {
+   Primary plain;
+   Primary rbpex;
+
+   PrimaryPrototype(const Parameter& p, const Node& n) : plain{p, n, false}, rbpex{p, n, true} {}
+   const Node& getNode() const { return plain.n; }
+   const Primary& get(bool useRbpex) const { return useRbpex ? rbpex : plain; }
+};
+//--------------------------------------------------------------------------------
 class Secondaries {
   const unsigned count;
-  Node n;
+  const Node& n;
 
 public:
-  Secondaries(unsigned c, Node n) : count{c}, n{n} {}
+  Secondaries(unsigned c, const Node& n) : count{c}, n{n} {}
   //  operator bool() const { return count != 0; }
   Price getPrice() const { return count * n.getPrice(); } // Make secondaries a bit more expensive for correct sorting
   bool hasStandby() const { return count > 0; }
@@ -140,8 +201,23 @@ struct Architecture {
    Secondaries secondaries;
    Latency opLatency;
    Latency commitLatency;
+   /// The demand of the required workload on every resource relative to its capacity, filled by the constructors
+   std::array<double, numResources> utilization{};
+   /// The capacity behind the recorded utilization of every resource, per second
+   std::array<double, numResources> capacity{};
    mutable std::optional<Price> cachedTotalPrice;
 
+   /// Keeps the higher utilization, so that reads and writes of one resource can be recorded separately
+   void setUtilization(Resource r, Rate demand, Rate capacity);
+   /// The EBS volumes of the primary, relative to the EBS limits of the machine
+   void setEBSUtilization();
+   /// The expected wait of a request at the resource under the required workload. The cores and the links derive their service time from
+   /// their capacity, the devices and services take the latency of one request, and serve as many requests in parallel as their capacity allows at that latency.
+   Latency getQueueingDelay(Resource r, Latency serviceTime = Latency{0ns}) const;
+   /// Adds the queueing delays to the latencies, if the parameters ask for it: every operation waits for a core,
+   /// a fraction of the operations at the resources of the op path (e.g., the cache misses at the storage), and every commit at the resources of the commit path
+   void addQueueingDelays(std::initializer_list<std::tuple<double, Resource, Latency>> opPath, std::initializer_list<std::pair<Resource, Latency>> commitPath);
+
    public:
    Architecture(const Parameter& p, const Primary& prim, ArchType t) : type{t}, parameter{p}, primary{prim}, secondaries{parameter.numSecondaries, prim.n} {}
    virtual ~Architecture() = default;
@@ -182,5 +258,14 @@ struct Architecture {
 
    virtual Latency getOpLatency() const { return opLatency; }
    virtual Latency getCommitLatency() const { return commitLatency; }
+
+   double getUtilization(Resource r) const { return utilization[static_cast<uint8_t>(r)]; }
+   /// The resource with the highest utilization that cannot grow with the workload, which limits the throughput first
+   Resource getBottleneck() const;
+   /// The largest transaction rate at the same update ratio. The cache hit rates do not depend on the load,
+   /// so the demand on every resource grows linearly with it until the bottleneck is saturated.
+   Rate getMaxTransactions() const;
+   /// The max transactions relative to the required ones
+   double getHeadroom() const;
 };
 //--------------------------------------------------------------------------------
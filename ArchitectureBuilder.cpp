@@ -7,6 +7,7 @@
 #include "InMemArchitecture.hpp"
 #include "RemoteBlockDeviceArchitecture.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <regex>
 #include <unordered_set>
@@ -95,8 +96,8 @@ int next_comb(BidiIter first, BidiIter last,
   return true;
 }
 //--------------------------------------------------------------------------------
-ArchitectureBuilder::ArchitectureBuilder(const VantageCSV& instances, Parameter p, std::string instanceFilterString, const std::vector<std::string>& architectures, const std::vector<std::string>& excludedArchitectures)
-   : instanceTypes{instances}, p{p} {
+ArchitectureBuilder::ArchitectureBuilder(const std::vector<Node>& nodes, Parameter p, std::string instanceFilterString, const std::vector<std::string>& architectures, const std::vector<std::string>& excludedArchitectures, ArchitectureSink& sink, unsigned threads, bool pruneDominated, Stats* stats)
+   : nodes{nodes}, p{p}, pruneDominated{pruneDominated}, sink{sink}, pool{threads}, stats{stats} {
 
    auto filters = infra::Parser::split(instanceFilterString, ',');
    if (filters.size() != 1 || filters[0] != "") {
@@ -106,9 +107,9 @@ ArchitectureBuilder::ArchitectureBuilder(const VantageCSV& instances, Parameter
    assembleArchitectures(architectures,excludedArchitectures);
 }
 //--------------------------------------------------------------------------------
-void ArchitectureBuilder::prepareNodes() {
-   nodes.clear();
-   for (auto& instanceType : instanceTypes) {
+vector<Node> ArchitectureBuilder::loadNodes(const VantageCSV& instances, double ec2Discount) {
+   vector<Node> nodes;
+   for (auto& instanceType : instances) {
       auto name = regex_replace(regex_replace(instanceType.name.get(), regex("large"), "l"), regex("medium"), "m");
       name = regex_replace(name, regex("([0-9]+)xl$"), "$1");
       if (!instanceType.consider.get()) continue;
@@ -117,19 +118,117 @@ void ArchitectureBuilder::prepareNodes() {
       if (instanceType.name.get().find("metal") != string::npos) continue;
       auto mem = Memory(1024_mib * instanceType.memory.getDouble());
       auto cpu = deriveCPU(instanceType);
-      auto price = Price::hourly(instanceType.price.getDouble() * (1.0 - p.ec2Discount));
+      auto price = Price::hourly(instanceType.price.getDouble() * (1.0 - ec2Discount));
       auto network = deriveNetworkSpeed(instanceType);
       auto iStorage = deriveInstanceStorage(instanceType);
       if (iStorage.type != InstanceStorage::Type::NVMe && iStorage.type != InstanceStorage::Type::None) continue;
       auto ebs = deriveMachineEBS(instanceType);
       nodes.push_back(Node{name, cpu, mem, network, price, iStorage, ebs});
    }
-   // Put copies of each element in the vector
-   cerr << "num instances: " << nodes.size() << "\n";
    // Build architectures out of `nodes` by iterating through all subsets
    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
       return a.name < b.name;
    });
+   return nodes;
+}
+//--------------------------------------------------------------------------------
+static bool hasSpecialModel(const Node& n) {
+   // These instances are special cased in the model, so their resources alone do not describe them
+   return n.name == "p4d.24" || n.name.starts_with("r5b");
+}
+//--------------------------------------------------------------------------------
+static bool dominates(const Node& a, const Node& b) {
+   if (!(a.price < b.price)) return false;
+   if (hasSpecialModel(a) || hasSpecialModel(b)) return false;
+   auto& as = a.instanceStorage;
+   auto& bs = b.instanceStorage;
+   // Socrates requires the buffer pool extension to be at least as large as the memory
+   bool aRbpex = as && as.getUsableSize() >= a.memory.getTotalSize();
+   bool bRbpex = bs && bs.getUsableSize() >= b.memory.getTotalSize();
+   return a.cpu.getOps(1) >= b.cpu.getOps(1) &&
+      a.memory.getTotalSize() >= b.memory.getTotalSize() &&
+      a.network.getReadLimit() >= b.network.getReadLimit() &&
+      a.network.getWriteLimit() >= b.network.getWriteLimit() &&
+      as.type == bs.type &&
+      as.getUsableSize() >= bs.getUsableSize() &&
+      as.getReadOps() >= bs.getReadOps() &&
+      as.getWriteOps() >= bs.getWriteOps() &&
+      (aRbpex || !bRbpex) &&
+      a.machineEbs.baseIops >= b.machineEbs.baseIops &&
+      a.machineEbs.baseThroughput >= b.machineEbs.baseThroughput &&
+      a.maxEBSDevices() >= b.maxEBSDevices();
+}
+//--------------------------------------------------------------------------------
+void ArchitectureBuilder::selectPrimaries() {
+   primaries.clear();
+   vector<const Node*> candidates;
+   for (auto& n : nodes) {
+      if (considerInstance(n)) candidates.push_back(&n);
+   }
+   if (pruneDominated) {
+      // Sort-filter skyline: after sorting by price, a node can only be dominated by a node in front of it,
+      // and as dominance is transitive it suffices to compare against the skyline found so far
+      auto byPrice = candidates;
+      std::stable_sort(byPrice.begin(), byPrice.end(), [](const Node* a, const Node* b) { return a->price < b->price; });
+      vector<const Node*> skyline;
+      unordered_set<const Node*> keep;
+      for (auto n : byPrice) {
+         if (std::none_of(skyline.begin(), skyline.end(), [&](const Node* s) { return dominates(*s, *n); })) {
+            skyline.push_back(n);
+            keep.insert(n);
+         }
+      }
+      std::erase_if(candidates, [&](const Node* n) { return !keep.contains(n); });
+      if (!stats) cerr << "Skyline primaries: " << candidates.size() << "\n";
+   }
+   // Keep the name order, so the enumeration order does not change
+   for (auto n : candidates) {
+      primaries.push_back(*n);
+   }
+   prototypes.clear();
+   prototypes.reserve(primaries.size());
+   for (auto& n : primaries) {
+      prototypes.emplace_back(p, n);
+   }
+}
+//--------------------------------------------------------------------------------
+void ArchitectureBuilder::selectStorageNodes() {
+   // Only choose the largest instance per type
+   unordered_map<string, const Node*> largest;
+   for (auto& n : nodes) {
+      if (!n.instanceStorage) continue;
+      auto [iter, inserted] = largest.emplace(n.getInstanceType(), &n);
+      if (!inserted && iter->second->cpu.count < n.cpu.count) {
+         iter->second = &n;
+      }
+   }
+   vector<const Node*> candidates;
+   for (auto& l : largest) {
+      candidates.push_back(l.second);
+   }
+   std::sort(candidates.begin(), candidates.end(), [](const Node* a, const Node* b) { return a->name < b->name; });
+
+   storageNodes.clear();
+   for (auto n : candidates) {
+      bool keep = std::none_of(candidates.begin(), candidates.end(), [&](const Node* d) {
+         return d->network.getReadLimit() > n->network.getReadLimit() && d->instanceStorage.isParetoBetter(n->instanceStorage) && d->price < n->price;
+      });
+      if (keep) {
+         storageNodes.push_back(*n);
+      }
+   }
+
+   logNodes.clear();
+   if (p.requiredUpdateOps == Rate::zero) {
+      // If there is nothing to log, just choose the cheapest instance
+      const Node* winner = &nodes.front();
+      for (auto& n : nodes) {
+         if (n.price < winner->price) winner = &n;
+      }
+      logNodes.push_back(*winner);
+   } else {
+      logNodes = storageNodes;
+   }
 }
 //--------------------------------------------------------------------------------
 bool ArchitectureBuilder::considerInstance(const Node& n) const {
@@ -140,288 +239,234 @@ bool ArchitectureBuilder::considerInstance(const Node& n) const {
   return false;
 }
 //--------------------------------------------------------------------------------
+bool ArchitectureBuilder::canSkip(ArchType t, Price lowerBound) {
+   auto cutoff = sink.getPriceCutoff(t);
+   // The bound sums up the prices in a different order, leave some room for rounding errors
+   if (!cutoff || lowerBound.value <= cutoff->value * (1 + 1e-9)) return false;
+   ++numPruned;
+   if (stats) ++(*stats)[t].pruned;
+   return true;
+}
+//--------------------------------------------------------------------------------
+bool ArchitectureBuilder::violatesConstraints(ArchType t, Durability durability, optional<Latency> opLatency) {
+   if (!sink.enforcesConstraints()) return false;
+   if (durability >= p.requiredDurability && (!opLatency || opLatency->avg <= p.requiredOpLatency.avg)) return false;
+   ++numRejected;
+   if (stats) ++(*stats)[t].rejected[static_cast<unsigned>(durability >= p.requiredDurability ? Rejection::Latency : Rejection::Durability)];
+   return true;
+}
+//--------------------------------------------------------------------------------
+void ArchitectureBuilder::countAttempt(ArchType t, bool assembled) {
+   if (!stats) return;
+   if (assembled) {
+      ++(*stats)[t].assembled;
+   } else {
+      ++(*stats)[t].rejected[static_cast<unsigned>(lastRejection)];
+      // A later failure that forgets to set its reason must not inherit this one
+      lastRejection = Rejection::Other;
+   }
+}
+//--------------------------------------------------------------------------------
+void ArchitectureBuilder::countRejected(ArchType t, Rejection reason, uint64_t count) {
+   if (stats) (*stats)[t].rejected[static_cast<unsigned>(reason)] += count;
+}
+//--------------------------------------------------------------------------------
+void ArchitectureBuilder::enumerate(uint64_t numTasks, const function<void(uint64_t, vector<unique_ptr<Architecture>>&)>& fn) {
+   auto firstBatch = nextBatch;
+   nextBatch += numTasks;
+   atomic<uint64_t> assembled = 0;
+   pool.run(numTasks, [&](uint64_t task) {
+      vector<unique_ptr<Architecture>> out;
+      fn(task, out);
+      assembled += out.size();
+      if (stats) {
+         auto start = steady_clock::now();
+         sink.offer(out, firstBatch + task);
+         stats->offerNanoseconds += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+      } else {
+         sink.offer(out, firstBatch + task);
+      }
+   });
+   numAssembled += assembled;
+}
+//--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleBasic() {
-  uint64_t before = architectures.size();
+  Stats::Phase phase{stats, "assembleBasic"};
+  uint64_t before = numAssembled;
   if (p.minSecondaries > 0) return;
   // The whole dataset has to fit on the single machine
-  for (auto& n : nodes) {
-     if (!considerInstance(n)) continue;
-     auto arch = Classic::assemble(p, n);
+  enumerate(primaries.size(), [&](uint64_t task, auto& out) {
+     auto& prototype = prototypes[task];
+     if (violatesConstraints(ArchType::Classic, InstanceStorageLogService::computeDurability(prototype.getNode()), Classic::computeOpLatency(prototype.plain))) return;
+     auto arch = Classic::assemble(p, prototype);
+     countAttempt(ArchType::Classic, arch != nullptr);
      if (arch) {
-        architectures.push_back(std::move(arch));
+        out.push_back(std::move(arch));
      }
-  }
-  cerr << "Create Classic architectures: " << (architectures.size() - before) << "\n";
+  });
+  if (!stats) cerr << "Create Classic architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleRemoteBlockDevice() {
-  uint64_t before = architectures.size();
+  Stats::Phase phase{stats, "assembleRemoteBlockDevice"};
+  uint64_t before = numAssembled;
   if (p.minSecondaries > 0) return;
   // The whole dataset has to fit on the single machine
-  for (auto& n : nodes) {
-     if (!considerInstance(n)) continue;
+  enumerate(primaries.size(), [&](uint64_t task, auto& out) {
      using T = EBS::Type;
+     auto& prototype = prototypes[task];
+     auto opLatency = RemoteBlockDevice::computeOpLatency(prototype.plain);
      for (auto t : {T::gp3, T::gp2, T::io2, T::io1}) {
-        auto arch = RemoteBlockDevice::assemble(p, n, t);
+        // The log lives on the same volume, so the volume type decides the durability
+        if (violatesConstraints(ArchType::RemoteBlockDevice, EBS::getDurability(t), opLatency)) continue;
+        auto arch = RemoteBlockDevice::assemble(p, prototype, t);
+        countAttempt(ArchType::RemoteBlockDevice, arch != nullptr);
         if (arch) {
-           architectures.push_back(std::move(arch));
+           out.push_back(std::move(arch));
         } else {
           //          cerr << "error with rbd: " << n.name << "\n";
         }
     }
-  }
-  cerr << "Create VBD architectures: " << (architectures.size() - before) << "\n";
+  });
+  if (!stats) cerr << "Create VBD architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleHadr() {
-  uint64_t before = architectures.size();
+  Stats::Phase phase{stats, "assembleHadr"};
+  uint64_t before = numAssembled;
   // The whole dataset has to fit on the single machine
-  for (auto& n : nodes) {
-     if (!considerInstance(n)) continue;
+  enumerate(primaries.size(), [&](uint64_t task, auto& out) {
+     auto& n = primaries[task];
+     auto opLatency = HADR::computeOpLatency(prototypes[task].plain);
      for (unsigned i = p.minSecondaries; i <= p.maxSecondaries; ++i) {
         if (i == 0) continue; // HADR always has at least one secondary
         auto p2 = p;
         p2.numSecondaries = i;
-        auto arch = HADR::assemble(p2, n);
+        // More secondaries only get more expensive
+        if (canSkip(ArchType::HADR, HADR::getPriceLowerBound(p2, n))) break;
+        // ... but more durable
+        if (violatesConstraints(ArchType::HADR, HADR::computeDurability(p2, n), opLatency)) continue;
+        auto arch = HADR::assemble(p2, prototypes[task]);
+        countAttempt(ArchType::HADR, arch != nullptr);
         if (arch) {
-           architectures.push_back(std::move(arch));
+           out.push_back(std::move(arch));
         }
      }
-  }
-  cerr << "Create HADR architectures: " << (architectures.size() - before) << "\n";
+  });
+  if (!stats) cerr << "Create HADR architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleInMem() {
-  uint64_t before = architectures.size();
+  Stats::Phase phase{stats, "assembleInMem"};
+  uint64_t before = numAssembled;
   if (p.minSecondaries > 0) return;
-  for (auto& n : nodes) {
-     if (!considerInstance(n)) continue;
-     auto arch = InMemory::assemble(p, n);
+  enumerate(primaries.size(), [&](uint64_t task, auto& out) {
+     // The log on the instance storage decides the durability, the latency only depends on the memory
+     if (violatesConstraints(ArchType::InMemory, InstanceStorageLogService::computeDurability(prototypes[task].getNode()))) return;
+     auto arch = InMemory::assemble(p, prototypes[task]);
+     countAttempt(ArchType::InMemory, arch != nullptr);
      if (arch) {
-        architectures.push_back(std::move(arch));
+        out.push_back(std::move(arch));
      }
-  }
-  cerr << "Create in-mem architectures: " << (architectures.size() - before) << "\n";
+  });
+  if (!stats) cerr << "Create in-mem architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleAuroraLike() {
-   uint64_t before = architectures.size();
-   auto getStorageInstances = [&]() {
-      unordered_map<string, Node> result;
-
-      for (auto& n : nodes) {
-         if (!n.instanceStorage) continue;
-         auto type = n.getInstanceType();
-         if (auto iter = result.find(type); iter != result.end()) {
-            if (iter->second.cpu.count < n.cpu.count) {
-               iter->second = n;
-            }
-         } else {
-            result.emplace(make_pair(type, n));
-         }
+   Stats::Phase phase{stats, "assembleAuroraLike"};
+   uint64_t before = numAssembled;
+   if (!stats) cerr << "Aurora storage nodes: (" << storageNodes.size() << ")\n";
+   // One task per (storage node, primary) pair, in the order of the nested loops
+   enumerate(storageNodes.size() * primaries.size(), [&](uint64_t task, auto& out) {
+      auto& s = storageNodes[task / primaries.size()];
+      // The durability only depends on the storage nodes, Aurora-like architectures are always filtered by it
+      auto maxSecondaries = std::min(p.maxSecondaries, AuroraLike::maxSecondaries);
+      if (CombinedPageServiceLog::computeDurability(s) < p.requiredDurability) {
+         if (maxSecondaries >= p.minSecondaries) countRejected(ArchType::AuroraLike, Rejection::Durability, maxSecondaries - p.minSecondaries + 1);
+         return;
       }
-      return result;
-   };
-   auto paretoInstances = [&]() {
-      auto res = getStorageInstances();
-      unordered_map<string, Node> result;
-
-      for (auto& r : res) {
-        bool keep = true;
-        for (auto& d : res) {
-          auto& n = r.second;
-          auto& dn = d.second;
-          if (dn.network.getReadLimit() > n.network.getReadLimit() && dn.instanceStorage.isParetoBetter(n.instanceStorage) && dn.price < n.price) {
-            keep = false;
-            break;
-          }
-        }
-        if (keep) {
-          result.insert(r);
-        }
-      }
-      return result;
-   };
-   cerr << "Aurora storage nodes: (" << paretoInstances().size() << ")\n";
-   for (auto& s : paretoInstances()) {
-      for (auto& n : nodes) {
-         if (!considerInstance(n)) continue;
-         for (unsigned i = p.minSecondaries; i <= std::min(p.maxSecondaries, AuroraLike::maxSecondaries); ++i) {
-            Parameter p2 = p;
-            p2.numSecondaries = i;
-            auto arch = AuroraLike::assemble(p2, n, s.second);
-            if (arch) {
-               if (arch->getDurability() >= p2.requiredDurability) {
-                  architectures.push_back(std::move(arch));
-               }
-            }
+      auto& prototype = prototypes[task % primaries.size()];
+      auto& n = prototype.getNode();
+      for (unsigned i = p.minSecondaries; i <= maxSecondaries; ++i) {
+         Parameter p2 = p;
+         p2.numSecondaries = i;
+         if (canSkip(ArchType::AuroraLike, AuroraLike::getPriceLowerBound(p2, n, s))) break;
+         auto arch = AuroraLike::assemble(p2, prototype, s);
+         countAttempt(ArchType::AuroraLike, arch != nullptr);
+         if (arch) {
+            out.push_back(std::move(arch));
          }
       }
-   }
-   cerr << "Create Aurora architectures: " << (architectures.size() - before) << "\n";
+   });
+   if (!stats) cerr << "Create Aurora architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleSocrates() {
-   uint64_t before = architectures.size();
-   auto getInstances = [&]() {
-      unordered_map<string, Node> result;
-
-      for (auto& n : nodes) {
-         if (!n.instanceStorage) continue;
-         auto type = n.getInstanceType();
-         // Only choose the largest instance per type
-         if (auto iter = result.find(type); iter != result.end()) {
-            if (iter->second.cpu.count < n.cpu.count) {
-               iter->second = n;
-            }
-         } else {
-            result.emplace(make_pair(type, n));
-         }
+   Stats::Phase phase{stats, "assembleSocrates"};
+   uint64_t before = numAssembled;
+   auto& pageNodes = storageNodes;
+   if (!stats) {
+      cerr << "Considered page servers for Socrates (" << pageNodes.size() << "): ";
+      for (auto& pageNode : pageNodes) {
+        cerr << pageNode.name << ",";
       }
-      return result;
-   };
-
-   auto paretoInstances = [&]() {
-      auto res = getInstances();
-      unordered_map<string, Node> pareto;
-
-      for (auto& r : res) {
-        bool keep = true;
-        for (auto& d : res) {
-          auto& n = r.second;
-          auto& dn = d.second;
-          if (dn.network.getReadLimit() > n.network.getReadLimit() && dn.instanceStorage.isParetoBetter(n.instanceStorage) && dn.price < n.price) {
-            keep = false;
-            break;
-          }
-        }
-        if (keep) {
-          pareto.insert(r);
-        }
-      }
-      vector<Node> result;
-      result.reserve(pareto.size());
-      for (auto& r : pareto) {
-        result.push_back(r.second);
-      }
-      return result;
-   };
-   auto logInstances = [&]() {
-      if (p.requiredUpdateOps == Rate::zero) {
-        // If there is nothing to log, just choose the cheapest instance
-        Node winner = nodes.front();
-        for (auto& n : nodes) {
-          if (n.price < winner.price) winner = n;
-        }
-
-        return vector<Node>{winner};
-      } else return paretoInstances();
-   };
-   cerr << "Considered page servers for Socrates (" << paretoInstances().size() << "): ";
-   for (auto& pageNode : paretoInstances()) {
-     cerr << pageNode.name << ",";
+      cerr << "\n";
+      cerr << "Considered log servers for Socrates (" << logNodes.size() << "): ";
    }
-   cerr << "\n";
-   cerr << "Considered log servers for Socrates (" << logInstances().size() << "): ";
    // for (auto& pageNode : filterPageInstances()) {
    //   cerr << "pageNode: " << pageNode.second.name << " " << pageNode.second.price << "\n";
    // }
    // exit(0);
 
    if (p.requiredDurability <= SocratesLike::durability) {
-      for (auto& pageNode : paretoInstances()) {
-         for (auto& logNode : logInstances()) {
-            for (auto& n : nodes) {
-               if (!considerInstance(n)) continue;
-               for (unsigned i = p.minSecondaries; i <= p.maxSecondaries; ++i) {
-                  auto p2 = p;
-                  p2.numSecondaries = i;
-                  auto arch = SocratesLike::assemble(p2, n, pageNode, logNode);
-                  if (arch) {
-                     architectures.push_back(std::move(arch));
-                  } else if (auto arch = SocratesLike::assemble(p2, n, pageNode, logNode, false)) {
-                     // Try again without rbpex, to avoid strange effects
-                     architectures.push_back(std::move(arch));
-                  }
-               }
+      // One task per (page node, log node, primary) triple, in the order of the nested loops
+      enumerate(pageNodes.size() * logNodes.size() * primaries.size(), [&](uint64_t task, auto& out) {
+         auto& pageNode = pageNodes[task / (logNodes.size() * primaries.size())];
+         auto& logNode = logNodes[(task / primaries.size()) % logNodes.size()];
+         auto& prototype = prototypes[task % primaries.size()];
+         auto& n = prototype.getNode();
+         for (unsigned i = p.minSecondaries; i <= p.maxSecondaries; ++i) {
+            auto p2 = p;
+            p2.numSecondaries = i;
+            if (canSkip(ArchType::SocratesLike, SocratesLike::getPriceLowerBound(p2, n, pageNode))) break;
+            auto arch = SocratesLike::assemble(p2, prototype, pageNode, logNode);
+            if (!arch) {
+               // Try again without rbpex, to avoid strange effects
+               arch = SocratesLike::assemble(p2, prototype, pageNode, logNode, false);
+            }
+            countAttempt(ArchType::SocratesLike, arch != nullptr);
+            if (arch) {
+               out.push_back(std::move(arch));
             }
          }
-      }
+      });
+   } else if (p.maxSecondaries >= p.minSecondaries) {
+      countRejected(ArchType::SocratesLike, Rejection::Durability, pageNodes.size() * logNodes.size() * primaries.size() * (p.maxSecondaries - p.minSecondaries + 1));
    }
-   cerr << "Create Socrates architectures: " << (architectures.size() - before) << "\n";
+   if (!stats) cerr << "Create Socrates architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleDynamic() {
-
-   uint64_t before = architectures.size();
-   auto getInstances = [&]() {
-      unordered_map<string, Node> result;
-
-      for (auto& n : nodes) {
-         if (!n.instanceStorage) continue;
-         auto type = n.getInstanceType();
-         // Only choose the largest instance per type
-         if (auto iter = result.find(type); iter != result.end()) {
-            if (iter->second.cpu.count < n.cpu.count) {
-               iter->second = n;
-            }
-         } else {
-            result.emplace(make_pair(type, n));
-         }
-      }
-      return result;
-   };
-
-   auto paretoInstances = [&]() {
-      auto res = getInstances();
-      unordered_map<string, Node> pareto;
-
-      for (auto& r : res) {
-        bool keep = true;
-        for (auto& d : res) {
-          auto& n = r.second;
-          auto& dn = d.second;
-          if (dn.network.getReadLimit() > n.network.getReadLimit() && dn.instanceStorage.isParetoBetter(n.instanceStorage) && dn.price < n.price) {
-            keep = false;
-            break;
-          }
-        }
-        if (keep) {
-          pareto.insert(r);
-        }
-      }
-      vector<Node> result;
-      result.reserve(pareto.size());
-      for (auto& r : pareto) {
-        result.push_back(r.second);
-      }
-      return result;
-   };
-   auto logInstances = [&]() {
-      if (p.requiredUpdateOps == Rate::zero) {
-        // If there is nothing to log, just choose the cheapest instance
-        Node winner = nodes.front();
-        for (auto& n : nodes) {
-          if (n.price < winner.price) winner = n;
-        }
-
-        return vector<Node>{winner};
-      } else return paretoInstances();
-   };
-
-   for (auto& n : nodes) {
-      if (!considerInstance(n)) continue;
-      auto arches = Dynamic::assemble(p, n, paretoInstances(), logInstances());
+   Stats::Phase phase{stats, "assembleDynamic"};
+   uint64_t before = numAssembled;
+   enumerate(primaries.size(), [&](uint64_t task, auto& out) {
+      auto arches = Dynamic::assemble(p, prototypes[task], storageNodes, logNodes);
+      // The variants are enumerated inside of the model, so only the assembled ones are counted
+      if (stats) (*stats)[ArchType::Dynamic].assembled += arches.size();
       for (auto& a : arches) {
-         architectures.push_back(std::move(a));
+         out.push_back(std::move(a));
       }
-   }
+   });
 
-   cerr << "Create Dynamic architectures: " << (architectures.size() - before) << "\n";
+   if (!stats) cerr << "Create Dynamic architectures: " << (numAssembled - before) << "\n";
 }
 //--------------------------------------------------------------------------------
 void ArchitectureBuilder::assembleArchitectures(const vector<string>& architectures, const vector<string>& excludedArchitectures) {
-   prepareNodes();
+   {
+      Stats::Phase phase{stats, "selectNodes"};
+      selectPrimaries();
+      selectStorageNodes();
+   }
 
    // std::sort(nodes.begin(),nodes.end(), [](auto& a, auto& b) { return a.getPricePerGBMemory() < b.getPricePerGBMemory(); });
    // for (auto& n : nodes) {
@@ -430,7 +475,7 @@ void ArchitectureBuilder::assembleArchitectures(const vector<string>& architectu
    // exit(1);
 
    for (auto& a : architectures) {
-      cerr << "Building arch: " << a << "\n";
+      if (!stats) cerr << "Building arch: " << a << "\n";
   }
   unordered_set<string> archs{architectures.begin(),architectures.end()};
   unordered_set<string> excludes{excludedArchitectures.begin(),excludedArchitectures.end()};
@@ -456,7 +501,11 @@ void ArchitectureBuilder::assembleArchitectures(const vector<string>& architectu
      assembleDynamic();
   }
 
-  cerr << "Num assembled architectures: " << architectures.size() << "\n";
+  if (!stats) {
+     cerr << "Num assembled architectures: " << numAssembled << "\n";
+     cerr << "Num pruned candidates: " << numPruned << "\n";
+     cerr << "Num rejected candidates: " << numRejected << "\n";
+  }
 }
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
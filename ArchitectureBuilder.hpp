@@ -1,22 +1,48 @@
 #pragma once
 #include "Common.hpp"
 #include "Architecture.hpp"
+#include "ArchitectureSink.hpp"
+#include "Stats.hpp"
+#include "infra/WorkStealingPool.hpp"
+#include <atomic>
+#include <functional>
 #include <iomanip>
 //--------------------------------------------------------------------------------
 using namespace std::chrono;
 //--------------------------------------------------------------------------------
 struct ArchitectureBuilder {
 
-   const VantageCSV& instanceTypes;
+   /// All instance types, sorted by name, see loadNodes
+   const std::vector<Node>& nodes;
    Parameter p;
    std::vector<std::string> instanceFilter;
-   std::vector<Node> nodes;
-   std::vector<std::unique_ptr<Architecture>> architectures;
+   /// The nodes that are considered as primaries
+   std::vector<Node> primaries;
+   /// The derived primaries for each of the primary nodes, in the same order
+   std::vector<PrimaryPrototype> prototypes;
+   /// Drop primaries that are dominated by a cheaper node with at least the same resources
+   bool pruneDominated;
+   /// The Pareto-optimal instances with instance storage, used as page servers and Aurora storage nodes
+   std::vector<Node> storageNodes;
+   /// The instances used for the log service
+   std::vector<Node> logNodes;
+   ArchitectureSink& sink;
+   infra::WorkStealingPool pool;
+   /// The number of assembled candidates (before the sink filters them)
+   uint64_t numAssembled = 0;
+   /// The number of candidates skipped because their price lower bound exceeded the sink's cutoff
+   std::atomic<uint64_t> numPruned = 0;
+   /// The number of candidates rejected before assembly because they would miss the required durability or latency
+   std::atomic<uint64_t> numRejected = 0;
+   uint64_t nextBatch = 0;
+   /// Collects the phase timings and the funnel instead of printing the counts, when set
+   Stats* stats;
 
-   ArchitectureBuilder(const VantageCSV& instances, Parameter p, std::string instanceFilter, const std::vector<std::string>& architectures, const std::vector<std::string>& excludedArchitectures);
+   ArchitectureBuilder(const std::vector<Node>& nodes, Parameter p, std::string instanceFilter, const std::vector<std::string>& architectures, const std::vector<std::string>& excludedArchitectures, ArchitectureSink& sink, unsigned threads = 1, bool pruneDominated = false, Stats* stats = nullptr);
 
    void assembleArchitectures(const std::vector<std::string>& architectures, const std::vector<std::string>& excludedArchitectures);
-   auto& getArchitectures() { return architectures; }
+   /// Derives the nodes from the instance catalog. They only depend on the EC2 discount, so they can be shared by multiple builders.
+   static std::vector<Node> loadNodes(const VantageCSV& instances, double ec2Discount);
 
    private:
    void assembleBasic();
@@ -27,7 +53,18 @@ struct ArchitectureBuilder {
    void assembleSocrates();
    void assembleDynamic();
 
-   void prepareNodes();
+   void selectPrimaries();
+   void selectStorageNodes();
+   /// Runs the tasks on the pool, every task fills its own buffer which is then handed to the sink as one batch
+   void enumerate(uint64_t numTasks, const std::function<void(uint64_t task, std::vector<std::unique_ptr<Architecture>>& out)>& fn);
 
    bool considerInstance(const Node& n) const;
+   /// Can a candidate with this price lower bound be skipped without changing the result?
+   bool canSkip(ArchType t, Price lowerBound);
+   /// Would the sink drop a candidate with this durability and op latency anyway?
+   bool violatesConstraints(ArchType t, Durability durability, std::optional<Latency> opLatency = std::nullopt);
+   /// Counts an assemble call in the funnel, a failed call by the reason that the model recorded
+   void countAttempt(ArchType t, bool assembled);
+   /// Counts candidates that were rejected without looking at them one by one
+   void countRejected(ArchType t, Rejection reason, uint64_t count);
 };
@@ -0,0 +1,19 @@
+#pragma once
+#include "Architecture.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+//--------------------------------------------------------------------------------
+/// Consumes the architectures while the builder assembles them, so they never have to be materialized all at once
+struct ArchitectureSink {
+   virtual ~ArchitectureSink() = default;
+   /// Takes over the candidates of one batch, may be called concurrently from multiple threads.
+   /// Batches are numbered in the serial enumeration order, which gives a deterministic tie-breaker.
+   virtual void offer(std::vector<std::unique_ptr<Architecture>>& batch, uint64_t batchId) = 0;
+   /// Candidates of this type that are more expensive than the cutoff would be dropped anyway, so the builder does not need to assemble them
+   virtual std::optional<Price> getPriceCutoff(ArchType) const { return std::nullopt; }
+   /// Does the sink drop candidates that miss the required durability or op latency of the parameters? Then the builder can reject them before assembly.
+   virtual bool enforcesConstraints() const { return false; }
+};
+//--------------------------------------------------------------------------------
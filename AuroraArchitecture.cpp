@@ -6,7 +6,7 @@
 using namespace std;
 using namespace infra;
 //--------------------------------------------------------------------------------
-AuroraLike::AuroraLike(Parameter p, Node n, Node storageNode) : Architecture{p, Primary{p, n}, ArchType::AuroraLike}, storageService{*CombinedPageServiceLog::assemble(parameter, primary, storageNode, Latency::deduce(parameter.requiredOpLatency, {{primary.probCacheHit(), primary.getCacheHitLatency()}}))} {
+AuroraLike::AuroraLike(Parameter p, const Primary& prim, const Node& storageNode) : Architecture{p, prim, ArchType::AuroraLike}, storageService{*CombinedPageServiceLog::assemble(parameter, primary, storageNode, Latency::deduce(parameter.requiredOpLatency, {{primary.probCacheHit(), primary.getCacheHitLatency()}}))} {
    // Updates
    Rate cpuUpdates = primary.n.cpu.getOps(parameter.cpuCost);
 
@@ -32,6 +32,15 @@ AuroraLike::AuroraLike(Parameter p, Node n, Node storageNode) : Architecture{p,
 
    secLookups = vmin(lookups * secondaries.availableForLookups(), p.requiredLookupOps - lookups);
 
+   // Utilization at the required rate, the storage service serves the page reads of all nodes and takes the log
+   auto opsPerNode = p.requiredOpsPerNode();
+   auto missesPerOp = primary.probCacheMiss() + primary.probIndexCacheMiss();
+   setUtilization(Resource::CPU, opsPerNode, cpuUpdates);
+   setUtilization(Resource::NetworkIn, opsPerNode * missesPerOp, primaryNetworkReads);
+   setUtilization(Resource::NetworkOut, p.requiredUpdateOps * (CombinedPageServiceLog::replication + secondaries.getCount()), primaryNetworkWrites);
+   setUtilization(Resource::PageService, p.requiredOps() * missesPerOp, storageReads);
+   setUtilization(Resource::PageService, p.requiredUpdateOps, storageWrites);
+
    primary.networkIn = (updates + lookups).rate * p.pageSize * p.networkOverhead * (primary.probCacheMiss() + primary.probIndexCacheMiss());
    primary.networkOut = updates.rate * p.getRedoLogRecordSize() * p.networkOverhead * (secondaries.getCount() + CombinedPageServiceLog::replication);
 
@@ -45,15 +54,25 @@ AuroraLike::AuroraLike(Parameter p, Node n, Node storageNode) : Architecture{p,
    commitLatency = storageService.getCommitLatency();
    opLatency = Latency::combine({{primary.probCacheHit(), Memory::readLatency},
                                  {primary.probCacheMiss(),storageService.getOpLatency()}});
+   // The cache misses and the log records pass the network of the primary and queue at the storage nodes
+   addQueueingDelays({{primary.probCacheMiss(), Resource::NetworkIn, Latency{0ns}}, {primary.probCacheMiss(), Resource::PageService, storageService.getOpLatency()}},
+                     {{Resource::NetworkOut, Latency{0ns}}, {Resource::PageService, commitLatency}});
+}
+//--------------------------------------------------------------------------------
+Price AuroraLike::getPriceLowerBound(const Parameter& p2, const Node& n, const Node& s) {
+   auto p = p2;
+   p.walIncludesUndo = false;
+   // Primary and secondaries, plus the share of the storage nodes that is needed to hold the data and log
+   return (1.0 + p.numSecondaries) * n.price + CombinedPageServiceLog::getStorageFraction(p, s) * s.price;
 }
 //--------------------------------------------------------------------------------
-unique_ptr<AuroraLike> AuroraLike::assemble(const Parameter& p2, const Node& n, const Node& s) {
+unique_ptr<AuroraLike> AuroraLike::assemble(const Parameter& p2, const PrimaryPrototype& prototype, const Node& s) {
    auto p = p2;
    p.walIncludesUndo = false;
    // We require instance storage on the storage node
    assert(s.instanceStorage);
 
-   Primary primary{p, n};
+   Primary primary{prototype.plain, p};
    // No limits on the storage service, it can scale arbitrarily
    auto adjustedOps = p.requiredOpsPerNode();
 
@@ -61,11 +80,11 @@ unique_ptr<AuroraLike> AuroraLike::assemble(const Parameter& p2, const Node& n,
       // We assume the replacement strategy is able to prioritize the index pages higher than the data pages
       // We need an additional page load for the index page perhaps
    auto networkReads = adjustedOps * (primary.probIndexCacheMiss() + primary.probCacheMiss()) * p.pageSize; // Page load for each cache miss
-   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return {};
-   if (networkWrites > primary.n.network.getWriteLimit()) return {};
-   if (networkReads > primary.n.network.getReadLimit()) return {};
+   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
+   if (networkWrites > primary.n.network.getWriteLimit()) return reject(Rejection::NetworkWrite);
+   if (networkReads > primary.n.network.getReadLimit()) return reject(Rejection::NetworkRead);
 
-   return make_unique<AuroraLike>(p, n, s);
+   return make_unique<AuroraLike>(p, primary, s);
 }
 //--------------------------------------------------------------------------------
 Durability AuroraLike::getDurability() const { return storageService.getDurability(); }
@@ -18,7 +18,7 @@ struct AuroraLike : public Architecture {
    const PageService& getPageService() const override { return storageService; }
    const LogService& getLogService() const override { return storageService; }
    /// Ctor
-   AuroraLike(Parameter p, Node n, Node storageNode);
+   AuroraLike(Parameter p, const Primary& prim, const Node& storageNode);
    uint64_t getS3Storage() const override { return 0; }
    Rate getS3GETRate() const override { return Rate::zero; }
    Rate getS3PUTRate() const override { return Rate::zero; }
@@ -33,6 +33,8 @@ struct AuroraLike : public Architecture {
 
    FailoverTime getFailoverTime() const override;
 
-   static std::unique_ptr<AuroraLike> assemble(const Parameter& p, const Node& n, const Node& s);
+   static std::unique_ptr<AuroraLike> assemble(const Parameter& p, const PrimaryPrototype& prototype, const Node& s);
+   /// A cheap lower bound on the total price of the architecture built by assemble
+   static Price getPriceLowerBound(const Parameter& p, const Node& n, const Node& s);
 };
 //--------------------------------------------------------------------------------
@@ -32,19 +32,31 @@ Classic::Classic(const Parameter& p, Primary prim)
    auto remainingReadOps = readIops - updates * readsPerUpdate;
    lookups = vmin(cpuLookups, remainingWriteOps / writesPerLookup, remainingReadOps / readsPerLookup, parameter.requiredLookupOps);
 
+   // Utilization at the required rate, all operations run on the primary
+   auto ops = parameter.requiredOps();
+   setUtilization(Resource::CPU, ops, cpuUpdates);
+   setUtilization(Resource::InstanceStorageIOPS, ops * readsPerLookup, readIops);
+   setUtilization(Resource::InstanceStorageIOPS, ops * writesPerLookup + parameter.requiredUpdateOps * logWritesPerUpdate, writeIops);
+
    primary.logVolume = updates.rate * parameter.getAriesLogRecordSize();
    commitLatency = InstanceStorage::writeLatency;
    // Assume all iops for the single page miss can be done in parallel, not increasing the latency
-   opLatency = Latency::combine({{primary.probCacheMiss(), InstanceStorage::readLatency}, {primary.probCacheHit(), Memory::readLatency}});
+   opLatency = computeOpLatency(primary);
+   // Under load, the cache misses and the log writes queue at the instance storage
+   addQueueingDelays({{primary.probCacheMiss(), Resource::InstanceStorageIOPS, InstanceStorage::readLatency}}, {{Resource::InstanceStorageIOPS, InstanceStorage::writeLatency}});
+}
+//--------------------------------------------------------------------------------
+Latency Classic::computeOpLatency(const Primary& primary) {
+   return Latency::combine({{primary.probCacheMiss(), InstanceStorage::readLatency}, {primary.probCacheHit(), Memory::readLatency}});
 }
 //--------------------------------------------------------------------------------
-unique_ptr<Classic> Classic::assemble(const Parameter& p2, const Node& n) {
+unique_ptr<Classic> Classic::assemble(const Parameter& p2, const PrimaryPrototype& prototype) {
    auto p = p2;
    assert(p.indexOnlyTables);
    p.walIncludesUndo = true;
    // We require instance storage
-   if (!n.instanceStorage) return {};
-   Primary primary{p, n};
+   if (!prototype.getNode().instanceStorage) return reject(Rejection::InstanceStorage);
+   Primary primary{prototype.plain, p};
 
    // Create an EBS device that fits both the database and the log
    auto size = p.getDataSize() + p.getRequiredAriesLogStorage();
@@ -56,19 +68,16 @@ unique_ptr<Classic> Classic::assemble(const Parameter& p2, const Node& n) {
 
    auto& storage = primary.n.instanceStorage;
 
-   if (p.requiredOps() > primary.n.cpu.getOps(p.cpuCost)) return {};
-   if (size > storage.getUsableSize()) return {};
-   if (pageReads > storage.getReadOps()) return {};
-   if ((pageWrites + logWrites) > storage.getWriteOps()) return {};
+   if (p.requiredOps() > primary.n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
+   if (size > storage.getUsableSize()) return reject(Rejection::StorageSize);
+   if (pageReads > storage.getReadOps()) return reject(Rejection::StorageIOPS);
+   if ((pageWrites + logWrites) > storage.getWriteOps()) return reject(Rejection::StorageIOPS);
 
    return make_unique<Classic>(p, primary);
 }
 //--------------------------------------------------------------------------------
 Durability Classic::getDurability() const {
-  // The probability of being durable is that we are durable in each month
-  double avail = primary.n.getAvailability().numericValue;
-  double d = std::pow(avail, 12);
-  return Durability{d};
+  return logService.getDurability();
 }
 //--------------------------------------------------------------------------------
 FailoverTime Classic::getFailoverTime() const {
@@ -26,6 +26,8 @@ struct Classic : public Architecture {
    Durability getDurability() const override;
    FailoverTime getFailoverTime() const override;
 
-   static std::unique_ptr<Classic> assemble(const Parameter& p, const Node& n);
+   static std::unique_ptr<Classic> assemble(const Parameter& p, const PrimaryPrototype& prototype);
+   /// Only depends on the cache hit rate, so it is known before assembly
+   static Latency computeOpLatency(const Primary& primary);
 };
 //--------------------------------------------------------------------------------
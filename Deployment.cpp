@@ -0,0 +1,115 @@
+#include "Deployment.hpp"
+#include "AuroraArchitecture.hpp"
+#include "ClassicArchitecture.hpp"
+#include "HADRArchitecture.hpp"
+#include "InMemArchitecture.hpp"
+#include "RemoteBlockDeviceArchitecture.hpp"
+#include "SocratesArchitecture.hpp"
+#include "infra/Config.hpp"
+#include "infra/Parser.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+//--------------------------------------------------------------------------------
+using namespace std;
+using namespace infra;
+//--------------------------------------------------------------------------------
+static const Node& findNode(const vector<Node>& nodes, const string& name) {
+   // The nodes are sorted by name, see ArchitectureBuilder::loadNodes
+   auto iter = lower_bound(nodes.begin(), nodes.end(), name, [](const Node& n, const string& name) { return n.name < name; });
+   if (iter == nodes.end() || iter->name != name) throw runtime_error("unknown instance '" + name + "'");
+   return *iter;
+}
+//--------------------------------------------------------------------------------
+Deployment Deployment::parse(string_view spec, const vector<Node>& nodes) {
+   unordered_map<string, string> values;
+   for (auto& entry : Parser::split(spec, ';')) {
+      if (entry.empty()) continue;
+      auto assignment = Parser::split(entry, '=');
+      if (assignment.size() != 2) throw runtime_error("invalid deployment entry '" + entry + "'");
+      if (!values.emplace(assignment[0], assignment[1]).second) throw runtime_error("duplicate deployment key '" + assignment[0] + "'");
+   }
+   auto take = [&](const string& key) -> optional<string> {
+      auto iter = values.find(key);
+      if (iter == values.end()) return nullopt;
+      auto value = std::move(iter->second);
+      values.erase(iter);
+      return value;
+   };
+   auto require = [&](const string& key, ArchType t) {
+      auto value = take(key);
+      if (!value) throw runtime_error("the " + archTypeToName(t) + " deployment needs '" + key + "'");
+      return *value;
+   };
+
+   Deployment d;
+   auto typeName = take("type");
+   if (!typeName) throw runtime_error("the deployment needs a 'type'");
+   optional<ArchType> type;
+   for (auto t : {ArchType::Classic, ArchType::HADR, ArchType::RemoteBlockDevice, ArchType::InMemory, ArchType::AuroraLike, ArchType::SocratesLike}) {
+      if (archTypeToName(t) == *typeName) type = t;
+   }
+   if (!type) throw runtime_error("unsupported deployment type '" + *typeName + "'");
+   d.type = *type;
+   d.primary = &findNode(nodes, require("primary", d.type));
+   if (auto secondaries = take("secondaries")) {
+      auto count = Parser::tryParseNumber(*secondaries);
+      if (!count) throw runtime_error("invalid value '" + *secondaries + "' for 'secondaries'");
+      d.secondaries = *count;
+   }
+   switch (d.type) {
+      case ArchType::Classic:
+      case ArchType::RemoteBlockDevice:
+      case ArchType::InMemory:
+         if (d.secondaries) throw runtime_error("the " + archTypeToName(d.type) + " deployment has no secondaries");
+         break;
+      case ArchType::HADR:
+         // HADR always has at least one secondary
+         if (!d.secondaries) d.secondaries = 1;
+         break;
+      case ArchType::AuroraLike:
+         if (d.secondaries > AuroraLike::maxSecondaries) throw runtime_error("an aurora deployment has at most " + to_string(AuroraLike::maxSecondaries) + " secondaries");
+         break;
+      default:
+         break;
+   }
+   if (d.type == ArchType::AuroraLike || d.type == ArchType::SocratesLike) {
+      d.page = &findNode(nodes, require("page", d.type));
+      if (!d.page->instanceStorage) throw runtime_error("the page server '" + d.page->name + "' has no instance storage");
+   }
+   if (d.type == ArchType::SocratesLike) {
+      d.log = &findNode(nodes, require("log", d.type));
+      if (auto rbpex = take("rbpex")) {
+         if (*rbpex != "true" && *rbpex != "false") throw runtime_error("invalid value '" + *rbpex + "' for 'rbpex'");
+         d.rbpex = (*rbpex == "true");
+      }
+   }
+   if (d.type == ArchType::RemoteBlockDevice) {
+      auto ebs = require("ebs", d.type);
+      optional<EBS::Type> ebsType;
+      for (auto t : {EBS::Type::gp3, EBS::Type::gp2, EBS::Type::io1, EBS::Type::io2}) {
+         if (EBS::getTypeName(t) == ebs) ebsType = t;
+      }
+      if (!ebsType) throw runtime_error("unknown ebs volume type '" + ebs + "'");
+      d.ebs = *ebsType;
+   }
+   if (!values.empty()) throw runtime_error("'" + values.begin()->first + "' does not apply to the " + archTypeToName(d.type) + " deployment");
+   return d;
+}
+//--------------------------------------------------------------------------------
+unique_ptr<Architecture> Deployment::assemble(Parameter p) const {
+   p.minSecondaries = p.maxSecondaries = p.numSecondaries = secondaries;
+   lastRejection = Rejection::Other;
+   PrimaryPrototype prototype{p, *primary};
+   switch (type) {
+      case ArchType::Classic: return Classic::assemble(p, prototype);
+      case ArchType::HADR: return HADR::assemble(p, prototype);
+      case ArchType::RemoteBlockDevice: return RemoteBlockDevice::assemble(p, prototype, ebs);
+      case ArchType::InMemory: return InMemory::assemble(p, prototype);
+      case ArchType::AuroraLike: return AuroraLike::assemble(p, prototype, *page);
+      case ArchType::SocratesLike: return SocratesLike::assemble(p, prototype, *page, *log, rbpex);
+      case ArchType::Dynamic: break;
+   }
+   unreachable();
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,26 @@
+#pragma once
+#include "Common.hpp"
+#include "Architecture.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+//--------------------------------------------------------------------------------
+/// An explicit deployment, e.g., an existing cluster, that is evaluated on its own instead of enumerating all candidates
+struct Deployment {
+   ArchType type;
+   const Node* primary = nullptr;
+   unsigned secondaries = 0;
+   /// The page servers of Socrates, or the storage nodes of Aurora
+   const Node* page = nullptr;
+   const Node* log = nullptr;
+   bool rbpex = true;
+   EBS::Type ebs = EBS::Type::gp3;
+
+   /// Parses a spec like 'type=socrates;primary=c6gd.l;secondaries=1;page=i3en.24;log=i4i.32;rbpex=false', the nodes are looked up by name
+   static Deployment parse(std::string_view spec, const std::vector<Node>& nodes);
+   /// Builds the architecture for the workload, or returns nullptr with the reason in lastRejection
+   std::unique_ptr<Architecture> assemble(Parameter p) const;
+};
+//--------------------------------------------------------------------------------
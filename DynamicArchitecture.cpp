@@ -26,12 +26,33 @@ Dynamic::Dynamic(const Parameter& p, unique_ptr<Primary> prim, unique_ptr<PageSe
 
    secLookups = vmin(lookups * secondaries.availableForLookups(), parameter.requiredLookupOps - lookups);
 
+   // Utilization at the required rate, services on the devices of the primary count for these devices
+   auto ops = parameter.requiredOps();
+   setUtilization(Resource::CPU, ops, cacheHitOps);
+   setUtilization(Resource::InstanceStorageIOPS, primary->reserved.reads, primary->n.instanceStorage.getReadOps());
+   setUtilization(Resource::InstanceStorageIOPS, primary->reserved.writes, primary->n.instanceStorage.getWriteOps());
+   setEBSUtilization();
+   if (auto log = dynamic_cast<const Ec2LogService*>(logService.get())) {
+      setUtilization(Resource::LogService, parameter.requiredUpdateOps, log->getNodeUpdateOps());
+   }
+   if (dynamic_cast<const Ec2PageService*>(pageService.get()) || dynamic_cast<const CombinedPageServiceLog*>(pageService.get())) {
+      setUtilization(Resource::PageService, ops * pageReadsPerOp, pageService->getPageReadOps());
+   }
+
 
    commitLatency = logService->getCommitLatency();
    opLatency = Latency::combine({{primary->probCacheMiss(), pageService->getOpLatency()}, {primary->probCacheHit(), primary->getCacheHitLatency()}});
+   // The services queue at the resource they were built on, like their utilization above
+   auto pageResource = Resource::PageService;
+   if (dynamic_cast<const InstanceStoragePageService*>(pageService.get())) pageResource = Resource::InstanceStorageIOPS;
+   if (dynamic_cast<const EBSPageService*>(pageService.get())) pageResource = Resource::EBS;
+   auto logResource = Resource::LogService;
+   if (dynamic_cast<const InstanceStorageLogService*>(logService.get())) logResource = Resource::InstanceStorageIOPS;
+   if (dynamic_cast<const EBSLogService*>(logService.get())) logResource = Resource::EBS;
+   addQueueingDelays({{primary->probCacheMiss(), pageResource, pageService->getOpLatency()}}, {{logResource, commitLatency}});
 }
 //--------------------------------------------------------------------------------
-vector<unique_ptr<Dynamic>> Dynamic::assemble(const Parameter& p2, const Node& n,  [[maybe_unused]] const vector<Node>& pageNodes, [[maybe_unused]] const vector<Node>& logNodes) {
+vector<unique_ptr<Dynamic>> Dynamic::assemble(const Parameter& p2, const PrimaryPrototype& prototype, [[maybe_unused]] const vector<Node>& pageNodes, [[maybe_unused]] const vector<Node>& logNodes) {
    vector<unique_ptr<Dynamic>> results;
 
    // So far: no secondaries, primary never uses rbpex
@@ -70,7 +91,7 @@ vector<unique_ptr<Dynamic>> Dynamic::assemble(const Parameter& p2, const Node& n
       // In-mem
       Parameter p = p3;
       unique_ptr<Primary> primary;
-      auto makePrimary = [&]() { return Primary::assemble(p, n, useRbpexOnPrimary); };
+      auto makePrimary = [&]() { return Primary::assemble(p, prototype.get(useRbpexOnPrimary)); };
       p.walIncludesUndo = false;
       auto refreshInMem = [&]() -> unique_ptr<PageService> {
          primary = makePrimary();
@@ -36,7 +36,7 @@ struct Dynamic : public Architecture {
   Rate getRandomUpdateTx() const override { return updates; }
   //  Secondaries secondaries;
 
-  static std::vector<std::unique_ptr<Dynamic>> assemble(const Parameter& p, const Node& n, const std::vector<Node>& page, const std::vector<Node>& log);
+  static std::vector<std::unique_ptr<Dynamic>> assemble(const Parameter& p, const PrimaryPrototype& prototype, const std::vector<Node>& page, const std::vector<Node>& log);
 };
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
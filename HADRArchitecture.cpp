@@ -38,11 +38,23 @@ HADR::HADR(const Parameter& p, Primary prim)
 
    secLookups = vmin(lookups * secondaries.availableForLookups(), parameter.requiredLookupOps - lookups);
 
+   // Utilization at the required rate, the lookups are distributed like in assemble
+   auto opsPerNode = parameter.requiredOpsPerNode();
+   setUtilization(Resource::CPU, opsPerNode, cpuUpdates);
+   setUtilization(Resource::InstanceStorageIOPS, opsPerNode * readsPerLookup, readIops);
+   setUtilization(Resource::InstanceStorageIOPS, opsPerNode * writesPerLookup + parameter.requiredUpdateOps * logWritesPerUpdate, writeIops);
+   setUtilization(Resource::NetworkOut, parameter.requiredUpdateOps, networkScale);
+
    primary.networkOut = updates.rate * parameter.getAriesLogRecordSize() * secondaries.getCount();
    primary.logVolume = updates.rate * parameter.getAriesLogRecordSize();
 
    commitLatency = InstanceStorage::writeLatency;
-   opLatency = Latency::combine({{primary.probCacheMiss(), InstanceStorage::readLatency}, {primary.probCacheHit(), primary.getCacheHitLatency()}});
+   opLatency = computeOpLatency(primary);
+   addQueueingDelays({{primary.probCacheMiss(), Resource::InstanceStorageIOPS, InstanceStorage::readLatency}}, {{Resource::InstanceStorageIOPS, InstanceStorage::writeLatency}});
+}
+//--------------------------------------------------------------------------------
+Latency HADR::computeOpLatency(const Primary& primary) {
+   return Latency::combine({{primary.probCacheMiss(), InstanceStorage::readLatency}, {primary.probCacheHit(), primary.getCacheHitLatency()}});
 }
 //--------------------------------------------------------------------------------
 uint64_t HADR::getInterAZTraffic() const {
@@ -53,13 +65,18 @@ uint64_t HADR::getInterAZTraffic() const {
    return x * updates.rate * parameter.getAriesLogRecordSize();
 }
 //--------------------------------------------------------------------------------
-unique_ptr<HADR> HADR::assemble(const Parameter& p2, Node n) {
+Price HADR::getPriceLowerBound(const Parameter& p, const Node& n) {
+   // Primary and secondaries, everything else only adds to it
+   return (1.0 + p.numSecondaries) * n.price;
+}
+//--------------------------------------------------------------------------------
+unique_ptr<HADR> HADR::assemble(const Parameter& p2, const PrimaryPrototype& prototype) {
    auto p = p2;
    assert(p.indexOnlyTables);
    p.walIncludesUndo = true;
    // We require instance storage
-   if (!n.instanceStorage) return {};
-   Primary primary{p, n};
+   if (!prototype.getNode().instanceStorage) return reject(Rejection::InstanceStorage);
+   Primary primary{prototype.plain, p};
 
    auto size = p.getDataSize() + p.getRequiredAriesLogStorage();
 
@@ -73,16 +90,20 @@ unique_ptr<HADR> HADR::assemble(const Parameter& p2, Node n) {
    auto networkWrites = p.requiredUpdateOps * p.getAriesLogRecordSize() * p.numSecondaries;
    auto& storage = primary.n.instanceStorage;
 
-   if (networkWrites > primary.getNetworkOutLimit()) return {};
-   if (size > storage.getUsableSize()) return {};
-   if (pageReads > storage.getReadOps()) return {};
-   if ((pageWrites + logWrites) > storage.getWriteOps()) return {};
-   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return {};
+   if (networkWrites > primary.getNetworkOutLimit()) return reject(Rejection::NetworkWrite);
+   if (size > storage.getUsableSize()) return reject(Rejection::StorageSize);
+   if (pageReads > storage.getReadOps()) return reject(Rejection::StorageIOPS);
+   if ((pageWrites + logWrites) > storage.getWriteOps()) return reject(Rejection::StorageIOPS);
+   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
    return make_unique<HADR>(p, primary);
 }
 //--------------------------------------------------------------------------------
 Durability HADR::getDurability() const  {
-  return Durability::calculateDurability(secondaries.getCount() + 1, primary.n.getAvailability().numericValue, parameter.getDataSize() / 50_mib, 1 /*We stay durable if one node survives*/);
+  return computeDurability(parameter, primary.n);
+}
+//--------------------------------------------------------------------------------
+Durability HADR::computeDurability(const Parameter& p, const Node& n) {
+  return Durability::calculateDurability(p.numSecondaries + 1, n.getAvailability().numericValue, p.getDataSize() / 50_mib, 1 /*We stay durable if one node survives*/);
 }
 //--------------------------------------------------------------------------------
 FailoverTime HADR::getFailoverTime() const {
@@ -27,6 +27,11 @@ struct HADR : public Architecture {
    Durability getDurability() const override;
    FailoverTime getFailoverTime() const override;
 
-   static std::unique_ptr<HADR> assemble(const Parameter& p, Node n);
+   static std::unique_ptr<HADR> assemble(const Parameter& p, const PrimaryPrototype& prototype);
+   /// A cheap lower bound on the total price of the architecture built by assemble
+   static Price getPriceLowerBound(const Parameter& p, const Node& n);
+   /// Durability and latency only depend on the node and the number of secondaries, so they are known before assembly
+   static Durability computeDurability(const Parameter& p, const Node& n);
+   static Latency computeOpLatency(const Primary& primary);
 };
 //--------------------------------------------------------------------------------
@@ -23,28 +23,33 @@ InMemory::InMemory(const Parameter& p, Primary prim)
    // Lookups
    lookups = vmin(cpuUpdates - updates, parameter.requiredLookupOps);
 
+   // Utilization at the required rate
+   setUtilization(Resource::CPU, parameter.requiredOps(), cpuUpdates);
+   setUtilization(Resource::InstanceStorageIOPS, parameter.requiredUpdateOps * writesPerUpdate, writeIops);
+
    primary.logVolume = updates.rate * parameter.getRedoLogRecordSize();
 
    commitLatency = logService.getCommitLatency();
    opLatency = pageService.getOpLatency();
+   // All data is in memory, only the log writes reach the instance storage
+   addQueueingDelays({}, {{Resource::InstanceStorageIOPS, commitLatency}});
 }
 //--------------------------------------------------------------------------------
-unique_ptr<InMemory> InMemory::assemble(const Parameter& p, const Node& n) {
+unique_ptr<InMemory> InMemory::assemble(const Parameter& p, const PrimaryPrototype& prototype) {
+   auto& n = prototype.getNode();
    assert(p.indexOnlyTables);
-   if (!n.instanceStorage && (p.requiredUpdateOps != Rate::zero)) return {};
-   if (n.memory.getTotalSize() < p.getDataSize()) return {};
-   if (p.requiredOps() > n.cpu.getOps(p.cpuCost)) return {};
+   if (!n.instanceStorage && (p.requiredUpdateOps != Rate::zero)) return reject(Rejection::InstanceStorage);
+   if (n.memory.getTotalSize() < p.getDataSize()) return reject(Rejection::Memory);
+   if (p.requiredOps() > n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
 
    // In-mem system only needs to persist redo log
    auto logWrites = p.requiredUpdateOps * (p.groupCommit ? (p.getRedoLogRecordSize() * 1.0) / InstanceStorage::MaxIOPSize : divRoundUp(p.getRedoLogRecordSize(), InstanceStorage::MaxIOPSize));
 
-   if ((logWrites > Rate::zero) && (logWrites > n.instanceStorage.getWriteOps())) return {};
-   if (p.getRequiredRedoLogStorage() > 0 && (p.getRequiredRedoLogStorage() > n.instanceStorage.getUsableSize())) return {};
-   if (p.requiredOps() > n.cpu.getOps(p.cpuCost)) return {};
-
-   Primary primary{p, n};
+   if ((logWrites > Rate::zero) && (logWrites > n.instanceStorage.getWriteOps())) return reject(Rejection::StorageIOPS);
+   if (p.getRequiredRedoLogStorage() > 0 && (p.getRequiredRedoLogStorage() > n.instanceStorage.getUsableSize())) return reject(Rejection::StorageSize);
+   if (p.requiredOps() > n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
 
-   return make_unique<InMemory>(p, primary);
+   return make_unique<InMemory>(p, Primary{prototype.plain, p});
 }
 //--------------------------------------------------------------------------------
 Durability InMemory::getDurability() const {
@@ -27,6 +27,6 @@ struct InMemory : public Architecture {
    Durability getDurability() const override;
    FailoverTime getFailoverTime() const override;
 
-   static std::unique_ptr<InMemory> assemble(const Parameter& p, const Node& n);
+   static std::unique_ptr<InMemory> assemble(const Parameter& p, const PrimaryPrototype& prototype);
 };
 //--------------------------------------------------------------------------------
@@ -26,8 +26,12 @@ InstanceStorageLogService::InstanceStorageLogService(const Parameter& p, Primary
    : LogService(p), primary{prim}, storage{inst} {}
 //--------------------------------------------------------------------------------
 Durability InstanceStorageLogService::getDurability() const {
+   return computeDurability(primary.n);
+}
+//--------------------------------------------------------------------------------
+Durability InstanceStorageLogService::computeDurability(const Node& n) {
    // The probability of being durable is that we are durable in each month
-   double avail = primary.n.getAvailability().numericValue;
+   double avail = n.getAvailability().numericValue;
    double d = std::pow(avail, 12);
    return Durability{d};
 }
@@ -96,7 +100,7 @@ unique_ptr<Ec2LogService> Ec2LogService::assemble(const Parameter& p, Primary& p
      // Prohibit scaling over one log node for now
      auto logTargets = p.numSecondaries + replication;
      auto scale = computeScale(p, logNode, logTargets);
-     if (scale > 1.0) return nullptr;
+     if (scale > 1.0) return reject(Rejection::LogServiceScale);
      return make_unique<Ec2LogService>(p, logNode, *ebs, scale, logTargets);
   }
 
@@ -107,6 +111,14 @@ Latency Ec2LogService::getCommitLatency() const { return EBS::writeLatency; }
 //--------------------------------------------------------------------------------
 Durability Ec2LogService::getDurability() const { return EBS::getDurability(logEBSDevice.type); }
 //--------------------------------------------------------------------------------
+Rate Ec2LogService::getNodeUpdateOps() const {
+   auto& p = parameter;
+   auto storageWriteVolume = Rate::secondly((1.0 * logNode.instanceStorage.getWriteThroughput()) / (p.getLogRecordSize() * getReplication()));
+   auto networkReads = logNode.network.getReadLimit() / (p.getLogRecordSize() * getReplication());
+   auto networkWrites = logNode.network.getWriteLimit() / (p.getLogRecordSize() * targets);
+   return vmin(storageWriteVolume, networkReads, networkWrites);
+}
+//--------------------------------------------------------------------------------
 Rate Ec2LogService::getUpdateOps() const {
    auto& p = parameter;
 
@@ -40,6 +40,7 @@ struct InstanceStorageLogService : public LogService {
    uint64_t getMaxIopSize() const override { return InstanceStorage::MaxIOPSize; }
    Rate getUpdateOps() const override;
    Durability getDurability() const override;
+   static Durability computeDurability(const Node& n);
 
    static std::unique_ptr<InstanceStorageLogService> assemble(const Parameter& p, Primary& prim);
 };
@@ -60,7 +61,7 @@ struct Ec2LogService : public LogService {
    /// The node type for the page service
    static constexpr double logServiceReplication = 1.0;
 
-   Node logNode;
+   const Node& logNode;
    double logNodeFraction;
    unsigned targets;
    EBSAllotment logEBSDevice;
@@ -72,6 +73,8 @@ struct Ec2LogService : public LogService {
    Price getPrice() const override { return logNodeFraction * logNode.price; }
 
    Rate getUpdateOps() const override;
+   /// The updates that a whole log node sustains, assemble never scales the service beyond one node
+   Rate getNodeUpdateOps() const;
 
    static double getReplication() { return logServiceReplication; }
 
@@ -1,31 +1,26 @@
 #include "Metric.hpp"
-#include <iomanip>
-#include <sstream>
 //--------------------------------------------------------------------------------
 using namespace std;
+using namespace infra;
 //--------------------------------------------------------------------------------
-void Metric::formatByte(std::ostream& out, uint64_t value, bool raw) {
+void Metric::formatByte(FormatBuffer& out, uint64_t value, bool raw) {
    if (raw) {
       out << value;
    } else {
-      stringstream ss;
-      infra::BinaryUnitInterpreter::print(ss, value);
-      ss << "b";
-      out << ss.str();
+      BinaryUnitInterpreter::print(out, value);
+      out << "b";
    }
 }
 //--------------------------------------------------------------------------------
-void Metric::formatPercentage(std::ostream& out, double value, bool raw) {
+void Metric::formatPercentage(FormatBuffer& out, double value, bool raw) {
    if (raw) {
       out << value;
    } else {
-      stringstream ss;
-      ss << fixed << setprecision(1) << 100 * value << "%";
-      out << ss.str();
+      out.appendFixed(100 * value, 1) << "%";
    }
 }
 //--------------------------------------------------------------------------------
-void Metric::formatHeader(ostream& out) {
+void Metric::formatHeader(FormatBuffer& out) {
   out << name;
 }
 //--------------------------------------------------------------------------------
@@ -1,9 +1,11 @@
 #pragma once
 //--------------------------------------------------------------------------------
+#include "infra/FormatBuffer.hpp"
 #include "infra/Parser.hpp"
 #include "infra/Terminal.hpp"
 #include <compare>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <iomanip>
 struct Architecture;
@@ -27,14 +29,19 @@ struct Metric {
    Metric(const std::string& n) : Metric{n, n.size()} { }
    Metric(const std::string& n, HiddenTag) : Metric{n, n.size() + 2} { hidden = true; }
 
-   void formatHeader(std::ostream& out);
-   virtual void formatValue(std::ostream& out, const Architecture&, bool = false) { out << "----"; }
-   virtual std::partial_ordering compare(const Architecture&, const Architecture&) const { throw std::runtime_error("sort not implemented for this visitor"); }
-   virtual bool shouldExclude(const Architecture&) const { return false; }
+   void formatHeader(infra::FormatBuffer& out);
+   virtual void formatValue(infra::FormatBuffer& out, const Architecture&, bool = false) { out << "----"; }
+   /// The value to sort and filter by. The registry evaluates it once per architecture and keeps it in a column.
+   virtual double getValue(const Architecture&) const { throw std::runtime_error("sort not implemented for this visitor"); }
+   /// The unit of getValue, e.g., "USD/h" or "ns". The columnar output exports metrics without unit as their formatted text.
+   virtual std::string_view getUnit() const { return {}; }
+   /// Does the metric constrain its value? Then getValue is also evaluated for filtering.
+   virtual bool hasConstraint() const { return false; }
+   virtual bool shouldExclude(double /*value*/) const { return false; }
 
    virtual const char* getColor(const Architecture&) const { return infra::Terminal::NOCOLOR; }
 
-   static void formatByte(std::ostream& out, uint64_t value, bool raw);
-   static void formatPercentage(std::ostream& out, double value, bool raw);
+   static void formatByte(infra::FormatBuffer& out, uint64_t value, bool raw);
+   static void formatPercentage(infra::FormatBuffer& out, double value, bool raw);
 };
 //--------------------------------------------------------------------------------
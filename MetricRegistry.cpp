@@ -1,122 +1,519 @@
 #include "MetricRegistry.hpp"
 #include "Architecture.hpp"
+#include "Metrics.hpp"
+#include "Stats.hpp"
+#include "infra/WorkStealingPool.hpp"
 #include <algorithm>
-#include <iomanip>
-#include <sstream>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <limits>
 using namespace std;
 //--------------------------------------------------------------------------------
-void MetricRegistry::insert(const Architecture& a) {
-   architectures[static_cast<uint8_t>(a.getType())].push_back(&a);
+MetricRegistry::MetricRegistry(bool csvFormat, bool showHidden, string csvDelimiter) : csvFormat{csvFormat}, showHidden{showHidden}, csvDelimiter{csvDelimiter} {
+   for (auto& c : priceCutoff) {
+      c = numeric_limits<double>::infinity();
+   }
+}
+//--------------------------------------------------------------------------------
+uint32_t MetricRegistry::Table::append(unique_ptr<Architecture> arch, pair<uint64_t, uint64_t> position, const double* values, string key) {
+   rows.push_back(std::move(arch));
+   positions.push_back(position);
+   keys.push_back(std::move(key));
+   alternatives.push_back(0);
+   for (unsigned c = 0; c < columns.size(); ++c) {
+      columns[c].push_back(values[c]);
+   }
+   return rows.size() - 1;
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::Table::moveRow(uint32_t from, uint32_t to) {
+   rows[to] = std::move(rows[from]);
+   positions[to] = positions[from];
+   keys[to] = std::move(keys[from]);
+   alternatives[to] = alternatives[from];
+   for (auto& column : columns) {
+      column[to] = column[from];
+   }
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::Table::popRow() {
+   rows.pop_back();
+   positions.pop_back();
+   keys.pop_back();
+   alternatives.pop_back();
+   for (auto& column : columns) {
+      column.pop_back();
+   }
+}
+//--------------------------------------------------------------------------------
+bool MetricRegistry::isBetter(const Table& ta, uint32_t a, const Table& tb, uint32_t b) const {
+   // The sort columns come first in the tables
+   for (unsigned c = 0; c < sortColumns.size(); ++c) {
+      auto reverse = sortColumns[c].first;
+      auto x = ta.columns[c][a];
+      auto y = tb.columns[c][b];
+      if (x < y) return !reverse;
+      if (x > y) return reverse;
+   }
+   // Ties are broken by the enumeration order, so the result does not depend on the number of threads
+   return ta.positions[a] < tb.positions[b];
+}
+//--------------------------------------------------------------------------------
+bool MetricRegistry::dominates(const Table& ta, uint32_t a, const Table& tb, uint32_t b) const {
+   bool better = false;
+   for (unsigned i = 0; i < paretoColumnIds.size(); ++i) {
+      auto c = paretoColumnIds[i];
+      auto x = ta.columns[c][a];
+      auto y = tb.columns[c][b];
+      if (paretoColumns[i].first) std::swap(x, y);
+      if (x > y) return false;
+      better |= x < y;
+   }
+   return better;
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::insertIntoSkyline(Table& t, uint32_t candidate) {
+   bool dedup = !dedupColumns.empty();
+   for (uint32_t row = 0; row < candidate; ++row) {
+      if (dominates(t, row, t, candidate)) {
+         if (auto it = t.index.find(t.keys[candidate]); it != t.index.end()) ++t.alternatives[it->second];
+         t.popRow();
+         return;
+      }
+   }
+   // Evict the dominated rows, compacting the table keeps the candidate last
+   uint32_t kept = 0;
+   for (uint32_t row = 0; row <= candidate; ++row) {
+      if (row != candidate && dominates(t, candidate, t, row)) {
+         if (dedup) {
+            if (t.keys[row] == t.keys[candidate]) t.alternatives[candidate] += t.alternatives[row] + 1;
+            t.index.erase(t.keys[row]);
+         }
+         continue;
+      }
+      if (kept != row) {
+         t.moveRow(row, kept);
+         if (dedup && row != candidate) t.index[t.keys[kept]] = kept;
+      }
+      ++kept;
+   }
+   while (t.rows.size() > kept) t.popRow();
+   candidate = kept - 1;
+   if (!dedup) return;
+   // Equivalent rows that do not dominate each other are collapsed into the better one
+   auto [it, inserted] = t.index.try_emplace(t.keys[candidate], candidate);
+   if (inserted) return;
+   auto existing = it->second;
+   if (isBetter(t, candidate, t, existing)) {
+      t.alternatives[candidate] += t.alternatives[existing] + 1;
+      t.moveRow(candidate, existing);
+   } else {
+      t.alternatives[existing] += t.alternatives[candidate] + 1;
+   }
+   t.popRow();
 }
 //--------------------------------------------------------------------------------
-void MetricRegistry::printHeader(std::ostream& out) {
+void MetricRegistry::updateColumns() {
+   columnMetrics.clear();
+   for (auto& [reverse, metric] : sortColumns) {
+      columnMetrics.push_back(metric);
+   }
+   auto getColumn = [&](Metric* m) -> unsigned {
+      auto it = std::find(columnMetrics.begin(), columnMetrics.end(), m);
+      if (it != columnMetrics.end()) return it - columnMetrics.begin();
+      columnMetrics.push_back(m);
+      return columnMetrics.size() - 1;
+   };
+   paretoColumnIds.clear();
+   for (auto& [reverse, metric] : paretoColumns) {
+      paretoColumnIds.push_back(getColumn(metric));
+   }
+   if (filterResults) {
+      for (auto& m : metrics) {
+         if (m->hasConstraint()) getColumn(m.get());
+      }
+   }
+   for (auto& t : architectures) {
+      assert(t.rows.empty());
+      t.columns.assign(columnMetrics.size(), {});
+   }
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::setFilter(bool filter) {
+   filterResults = filter;
+   updateColumns();
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::setDedup(string_view keyColumns) {
+   dedupColumns.clear();
+   for (auto& name : infra::Parser::split(keyColumns, ',')) {
+      if (name.empty()) continue;
+      auto it = std::find_if(metrics.begin(), metrics.end(), [&](auto& m) { return m->name == name; });
+      // The id is only assigned when printing
+      if (it == metrics.end() || name == "id") {
+         throw runtime_error("unknown dedup column '" + name + "'");
+      }
+      dedupColumns.push_back(it->get());
+   }
+   if (!dedupColumns.empty() && !alternativesMetric) {
+      add<AlternativesMetric>();
+      alternativesMetric = static_cast<AlternativesMetric*>(metrics.back().get());
+   }
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::offer(vector<unique_ptr<Architecture>>& batch, uint64_t batchId) {
+   // Evaluating the metrics runs the model code, so do it outside of the lock
+   auto numColumns = columnMetrics.size();
+   vector<double> values(batch.size() * numColumns);
+   vector<string> keys(batch.size());
+   infra::FormatBuffer key;
+   for (uint64_t i = 0; i < batch.size(); ++i) {
+      for (unsigned c = 0; c < numColumns; ++c) {
+         auto& metric = *columnMetrics[c];
+         auto v = metric.getValue(*batch[i]);
+         values[i * numColumns + c] = v;
+         if (filterResults && metric.hasConstraint() && metric.shouldExclude(v)) {
+            if (stats) ++(*stats)[batch[i]->getType()].filtered;
+            batch[i].reset();
+            break;
+         }
+      }
+      if (!batch[i] || dedupColumns.empty()) continue;
+      // The key consists of the values as they are printed, so rows that look the same are collapsed
+      key.clear();
+      for (auto m : dedupColumns) {
+         m->formatValue(key, *batch[i], csvFormat);
+         key << '\0';
+      }
+      keys[i] = key.str();
+   }
+   bool sortedByPrice = !sortColumns.empty() && sortColumns.front().second->name == "TotalPrice" && !sortColumns.front().first;
+   lock_guard lock{mutex};
+   for (uint64_t i = 0; i < batch.size(); ++i) {
+      if (!batch[i]) continue;
+      auto type = static_cast<uint8_t>(batch[i]->getType());
+      auto& t = architectures[type];
+      auto row = t.append(std::move(batch[i]), pair(batchId, i), &values[i * numColumns], std::move(keys[i]));
+      if (!paretoColumns.empty()) {
+         insertIntoSkyline(t, row);
+         continue;
+      }
+      auto comp = [&](uint32_t a, uint32_t b) { return isBetter(t, a, t, b); };
+      if (!dedupColumns.empty()) {
+         if (auto it = t.index.find(t.keys[row]); it != t.index.end()) {
+            // An equivalent architecture is retained already, keep the better one of both
+            auto existing = it->second;
+            if (isBetter(t, row, t, existing)) {
+               t.alternatives[row] = t.alternatives[existing] + 1;
+               t.moveRow(row, existing);
+               if (!sortColumns.empty()) std::make_heap(t.heap.begin(), t.heap.end(), comp);
+            } else {
+               ++t.alternatives[existing];
+            }
+            t.popRow();
+            if (!t.heap.empty() && t.heap.size() == minPerArch && sortedByPrice) {
+               priceCutoff[type] = t.columns[0][t.heap.front()];
+            }
+            continue;
+         }
+      }
+      if (sortColumns.empty()) {
+         if (!dedupColumns.empty()) t.index.emplace(t.keys[row], row);
+         continue;
+      }
+      if (t.heap.size() < minPerArch) {
+         if (!dedupColumns.empty()) t.index.emplace(t.keys[row], row);
+         t.heap.push_back(row);
+         std::push_heap(t.heap.begin(), t.heap.end(), comp);
+      } else if (!t.heap.empty() && isBetter(t, row, t, t.heap.front())) {
+         // Replace the worst retained architecture of this type
+         std::pop_heap(t.heap.begin(), t.heap.end(), comp);
+         auto slot = t.heap.back();
+         if (!dedupColumns.empty()) {
+            t.index.erase(t.keys[slot]);
+            t.index.emplace(t.keys[row], slot);
+         }
+         t.moveRow(row, slot);
+         t.popRow();
+         std::push_heap(t.heap.begin(), t.heap.end(), comp);
+      } else {
+         t.popRow();
+      }
+      // Once the heap is full, only candidates at most as expensive as its worst one can get in
+      if (!t.heap.empty() && t.heap.size() == minPerArch && sortedByPrice) {
+         priceCutoff[type] = t.columns[0][t.heap.front()];
+      }
+   }
+   batch.clear();
+}
+//--------------------------------------------------------------------------------
+optional<Price> MetricRegistry::getPriceCutoff(ArchType t) const {
+   double cutoff = priceCutoff[static_cast<uint8_t>(t)];
+   if (!pruning || cutoff == numeric_limits<double>::infinity()) return nullopt;
+   return Price::hourly(cutoff);
+}
+//--------------------------------------------------------------------------------
+vector<MetricRegistry::PrintedColumn> MetricRegistry::getPrintedColumns() const {
+   vector<PrintedColumn> result;
    for (auto i = 0u; i < metrics.size(); ++i) {
-      auto& v = *metrics[i];
-      if (v.hidden && !showHidden) continue;
+      auto& metric = *metrics[i];
+      if (metric.hidden && !showHidden) continue;
+      result.push_back({&metric, (i + 1) != metrics.size(), metric.align == Metric::Align::Left});
+   }
+   return result;
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::formatHeader(infra::FormatBuffer& out, const vector<PrintedColumn>& columns) {
+   for (auto& [metric, delimiter, alignLeft] : columns) {
       if (csvFormat) {
-         v.formatHeader(out);
-         if ((i + 1) != metrics.size()) out << csvDelimiter;
+         metric->formatHeader(out);
+         if (delimiter) out << csvDelimiter;
       } else {
-         if (v.align == Metric::Align::Left) {
-            out << left;
-         } else {
-            out << right;
-         }
-         out << setw(v.printWidth);
-         stringstream tmp;
-         v.formatHeader(tmp);
-         auto tmp2 = tmp.str();
-         string trunc = tmp2.size() <= v.printWidth ? tmp2 : tmp2.substr(0, v.printWidth - 2) + "..";
-         out << trunc;
+         auto start = out.size();
+         metric->formatHeader(out);
+         out.fit(start, metric->printWidth, alignLeft);
          out << infra::Terminal::DARKGREY << "|" << infra::Terminal::NOCOLOR;
       }
    }
    out << "\n";
 }
 //--------------------------------------------------------------------------------
-void MetricRegistry::printArch(std::ostream& out, const Architecture& a, size_t) {
-   for (auto i = 0u; i < metrics.size(); ++i) {
-      auto& metric = *metrics[i];
-      if (metric.hidden && !showHidden) continue;
+void MetricRegistry::formatArch(infra::FormatBuffer& out, const vector<PrintedColumn>& columns, const Architecture& a) {
+   for (auto& [metric, delimiter, alignLeft] : columns) {
       if (csvFormat) {
-         metric.formatValue(out, a, true /*raw*/);
-         if ((i + 1) != metrics.size()) out << csvDelimiter;
+         metric->formatValue(out, a, true /*raw*/);
+         if (delimiter) out << csvDelimiter;
       } else {
-         if (metric.align == Metric::Align::Left) {
-            out << left;
-         } else {
-            out << right;
-         }
-         out << metric.getColor(a);
-         out << setw(metric.printWidth);
-         stringstream tmp;
-         metric.formatValue(tmp, a);
-         auto tmp2 = tmp.str();
-         string trunc = tmp2.size() <= metric.printWidth ? tmp2 : tmp2.substr(0, metric.printWidth - 2) + "..";
-         out << trunc;
+         out << metric->getColor(a);
+         auto start = out.size();
+         metric->formatValue(out, a);
+         out.fit(start, metric->printWidth, alignLeft);
          out << infra::Terminal::DARKGREY << "|" << infra::Terminal::NOCOLOR;
       }
    }
    out << "\n";
 }
 //--------------------------------------------------------------------------------
+void MetricRegistry::printHeader(ostream& out) {
+   infra::FormatBuffer buffer;
+   formatHeader(buffer, getPrintedColumns());
+   buffer.flush(out);
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::printArch(ostream& out, const Architecture& a, size_t) {
+   infra::FormatBuffer buffer;
+   formatArch(buffer, getPrintedColumns(), a);
+   buffer.flush(out);
+}
+//--------------------------------------------------------------------------------
 void MetricRegistry::print(ostream& out) {
-   uint64_t i = 0;
-   if (!overallSort.empty()) {
-      for (auto& a : overallSort) {
-         printArch(out, *a, i);
-         ++i;
-      }
-   } else {
-      for (auto& aType : architectures) {
-         for (auto& a : aType) {
-            printArch(out, *a, i);
-            ++i;
+   // Format all rows into one buffer, which is handed to the stream in large chunks
+   static constexpr size_t flushThreshold = 1 << 16;
+   auto columns = getPrintedColumns();
+   infra::FormatBuffer buffer;
+   for (auto& a : overallSort) {
+      formatArch(buffer, columns, *a);
+      if (buffer.size() >= flushThreshold) buffer.flush(out);
+   }
+   buffer.flush(out);
+}
+//--------------------------------------------------------------------------------
+/// The header of the columnar output, followed by one ColumnarEntry per column and the column data (see README)
+struct ColumnarHeader {
+   char magic[8];
+   uint32_t version;
+   uint32_t numColumns;
+   uint64_t numRows;
+   uint64_t reserved;
+};
+struct ColumnarEntry {
+   /// Zero padded, not terminated when the name uses all bytes
+   char name[32];
+   char unit[16];
+   uint32_t type;
+   uint32_t reserved;
+   /// The position of the column data from the start of the file, always a multiple of 8
+   uint64_t offset;
+   uint64_t bytes;
+};
+static_assert(sizeof(ColumnarHeader) == 32 && sizeof(ColumnarEntry) == 72);
+static_assert(endian::native == endian::little, "the columnar output is little endian");
+//--------------------------------------------------------------------------------
+void MetricRegistry::printColumnar(ostream& out) {
+   static constexpr char magic[8] = {'C', 'C', 'C', 'O', 'L', 'S', '\0', '\0'};
+   static constexpr uint32_t version = 1;
+   enum ColumnType : uint32_t { Float64 = 0, Text = 1 };
+   struct Column {
+      Metric* metric;
+      ColumnType type;
+      vector<double> values;
+      /// For text: numRows + 1 offsets into the concatenated text
+      vector<uint64_t> offsets;
+      infra::FormatBuffer text;
+   };
+   auto align = [](uint64_t bytes) { return (bytes + 7) & ~uint64_t{7}; };
+
+   // The id is the position of the row
+   vector<Column> columns;
+   for (auto& printed : getPrintedColumns()) {
+      if (printed.metric->name == "id") continue;
+      columns.push_back(Column{printed.metric, printed.metric->getUnit().empty() ? Text : Float64, {}, {}, {}});
+   }
+   for (auto& c : columns) {
+      if (c.type == Float64) {
+         c.values.reserve(overallSort.size());
+         for (auto a : overallSort) c.values.push_back(c.metric->getValue(*a));
+      } else {
+         c.offsets.reserve(overallSort.size() + 1);
+         c.offsets.push_back(0);
+         for (auto a : overallSort) {
+            c.metric->formatValue(c.text, *a, true /*raw*/);
+            c.offsets.push_back(c.text.size());
          }
       }
    }
+
+   ColumnarHeader header{};
+   memcpy(header.magic, magic, sizeof(magic));
+   header.version = version;
+   header.numColumns = columns.size();
+   header.numRows = overallSort.size();
+   vector<ColumnarEntry> entries(columns.size());
+   uint64_t offset = sizeof(header) + entries.size() * sizeof(ColumnarEntry);
+   for (unsigned i = 0; i < columns.size(); ++i) {
+      auto& c = columns[i];
+      auto& e = entries[i];
+      c.metric->name.copy(e.name, sizeof(e.name));
+      c.metric->getUnit().copy(e.unit, sizeof(e.unit));
+      e.type = c.type;
+      e.offset = offset;
+      e.bytes = c.type == Float64 ? c.values.size() * sizeof(double) : c.offsets.size() * sizeof(uint64_t) + c.text.size();
+      offset += align(e.bytes);
+   }
+
+   static constexpr char padding[8] = {};
+   out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+   out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ColumnarEntry));
+   for (unsigned i = 0; i < columns.size(); ++i) {
+      auto& c = columns[i];
+      if (c.type == Float64) {
+         out.write(reinterpret_cast<const char*>(c.values.data()), c.values.size() * sizeof(double));
+      } else {
+         out.write(reinterpret_cast<const char*>(c.offsets.data()), c.offsets.size() * sizeof(uint64_t));
+         c.text.flush(out);
+      }
+      out.write(padding, align(entries[i].bytes) - entries[i].bytes);
+   }
 }
 //--------------------------------------------------------------------------------
-void MetricRegistry::sortAndTrunc(string_view col, size_t minPerArch) {
-   auto sortCols = infra::Parser::split(col, ',');
-   vector<pair<bool,Metric*>> sortColRefs;
-   for (auto& s : sortCols) {
+vector<pair<bool, Metric*>> MetricRegistry::resolveColumns(string_view columns, string_view what) const {
+   auto names = infra::Parser::split(columns, ',');
+   vector<pair<bool, Metric*>> result;
+   for (auto& s : names) {
      bool reverse = s[0] == '-';
      auto cmp = s.substr(reverse);
      for (auto& m : metrics) {
         if (m->name == cmp) {
-           sortColRefs.push_back(make_pair(reverse, m.get()));
+           result.push_back(make_pair(reverse, m.get()));
         }
      }
    }
-   if (sortColRefs.empty() || (sortColRefs.size() != sortCols.size())) {
-      throw runtime_error("unknown sort column(s) '"s + string(col) + "'");
+   if (result.empty() || (result.size() != names.size())) {
+      throw runtime_error("unknown "s + string(what) + " column(s) '" + string(columns) + "'");
    }
-   auto comp = [&](const auto& a, const auto& b) {
-      for (auto s : sortColRefs) {
-         auto reverse = s.first;
-         auto res = s.second->compare(*a, *b);
-         if (res == 0) continue;
-         if (res < 0) return !reverse;
-         if (res > 0) return reverse;
-      }
-      return false;
-   };
-   for (auto& at : architectures) {
-     auto elemsToConsider = std::min(at.size(), minPerArch);
-      std::partial_sort(at.begin(), at.begin() + elemsToConsider, at.end(), comp);
-      at.resize(elemsToConsider);
-      for (auto& a : at) {
-         overallSort.push_back(a);
+   return result;
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::setSortOrder(string_view col, size_t minPerArch) {
+   sortColumns = resolveColumns(col, "sort");
+   this->minPerArch = minPerArch;
+   updateColumns();
+}
+//--------------------------------------------------------------------------------
+void MetricRegistry::setPareto(string_view columns) {
+   paretoColumns.clear();
+   if (!columns.empty()) {
+      paretoColumns = resolveColumns(columns, "pareto");
+      // Show what the frontier is computed on, even if the metric is hidden by default
+      for (auto& [reverse, metric] : paretoColumns) {
+         metric->hidden = false;
       }
-      //   std::sort(architectures.begin(), architectures.end(), comp);
    }
-   std::sort(overallSort.begin(), overallSort.end(), comp);
+   updateColumns();
 }
 //--------------------------------------------------------------------------------
-void MetricRegistry::filter() {
-   for (auto& at : architectures) {
-      std::erase_if(at, [&](auto a) { return std::any_of(metrics.begin(), metrics.end(), [&](auto& m) { return m->shouldExclude(*a); }); });
+void MetricRegistry::sortAndTrunc(unsigned threads) {
+   // Only permute references to the rows, the values were materialized when the architectures were offered
+   using Ref = pair<const Table*, uint32_t>;
+   auto enumerationOrder = [](const Ref& a, const Ref& b) { return pair(a.first, a.first->positions[a.second]) < pair(b.first, b.first->positions[b.second]); };
+   // The tables only hold the skyline of their type, the union still contains points that another type dominates.
+   // Sort-filter-skyline: in lexicographic order of the pareto metrics, no point is dominated by a later one.
+   auto lexicographic = [&](const Ref& a, const Ref& b) {
+      for (unsigned i = 0; i < paretoColumnIds.size(); ++i) {
+         auto x = a.first->columns[paretoColumnIds[i]][a.second];
+         auto y = b.first->columns[paretoColumnIds[i]][b.second];
+         if (x != y) return paretoColumns[i].first ? x > y : x < y;
+      }
+      return enumerationOrder(a, b);
+   };
+   auto ranking = [&](const Ref& a, const Ref& b) { return isBetter(*a.first, a.second, *b.first, b.second); };
+   // All orders are total, as the enumeration position is unique, so the merged result does not depend on the number of threads
+   function<bool(const Ref&, const Ref&)> order;
+   if (!paretoColumns.empty()) {
+      order = lexicographic;
+   } else if (sortColumns.empty()) {
+      // Batches may arrive out of order when building in parallel
+      order = enumerationOrder;
+   } else {
+      order = ranking;
+   }
+
+   // Sort every type on its own, then merge the sorted runs pairwise until only one is left
+   infra::WorkStealingPool pool{threads};
+   vector<vector<Ref>> runs(architectures.size());
+   pool.run(architectures.size(), [&](uint64_t type) {
+      auto& t = architectures[type];
+      auto& run = runs[type];
+      run.reserve(t.rows.size());
+      for (uint32_t row = 0; row < t.rows.size(); ++row) {
+         run.emplace_back(&t, row);
+      }
+      std::sort(run.begin(), run.end(), order);
+   });
+   while (runs.size() > 1) {
+      vector<vector<Ref>> merged((runs.size() + 1) / 2);
+      pool.run(merged.size(), [&](uint64_t i) {
+         if (2 * i + 1 == runs.size()) {
+            merged[i] = std::move(runs[2 * i]);
+            return;
+         }
+         auto& a = runs[2 * i];
+         auto& b = runs[2 * i + 1];
+         merged[i].resize(a.size() + b.size());
+         std::merge(a.begin(), a.end(), b.begin(), b.end(), merged[i].begin(), order);
+      });
+      runs = std::move(merged);
+   }
+   auto all = std::move(runs.front());
+
+   if (!paretoColumns.empty()) {
+      vector<Ref> skyline;
+      for (auto& p : all) {
+         if (std::none_of(skyline.begin(), skyline.end(), [&](auto& s) { return dominates(*s.first, s.second, *p.first, p.second); })) {
+            skyline.push_back(p);
+         }
+      }
+      all = std::move(skyline);
+      // Without sort columns, keep the frontier in the lexicographic order
+      if (!sortColumns.empty()) std::sort(all.begin(), all.end(), ranking);
+   }
+   overallSort.clear();
+   for (auto& [table, row] : all) {
+      overallSort.push_back(table->rows[row].get());
+      if (alternativesMetric) alternativesMetric->counts[table->rows[row].get()] = table->alternatives[row];
+      if (stats) ++(*stats)[table->rows[row]->getType()].printed;
    }
 }
 //--------------------------------------------------------------------------------
@@ -1,36 +1,114 @@
 #pragma once
+#include "ArchitectureSink.hpp"
 #include "Metric.hpp"
 #include <array>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 //--------------------------------------------------------------------------------
 struct Architecture;
+struct AlternativesMetric;
+struct Stats;
 //--------------------------------------------------------------------------------
-struct MetricRegistry {
+struct MetricRegistry : public ArchitectureSink {
+   /// The retained architectures of one type. The column metrics are evaluated once when an architecture is offered,
+   /// so filtering and sorting never have to call back into the model.
+   struct Table {
+      std::vector<std::unique_ptr<Architecture>> rows;
+      /// The position in the enumeration order (batch, index in batch), which breaks ties
+      std::vector<std::pair<uint64_t, uint64_t>> positions;
+      /// One vector of values per column metric, indexed by row
+      std::vector<std::vector<double>> columns;
+      /// When sorting: a max-heap of row ids with the worst retained row on top
+      std::vector<uint32_t> heap;
+      /// When deduplicating: the equivalence key of every row, the number of candidates merged into it, and the row of every key
+      std::vector<std::string> keys;
+      std::vector<uint64_t> alternatives;
+      std::unordered_map<std::string, uint32_t> index;
+
+      uint32_t append(std::unique_ptr<Architecture> arch, std::pair<uint64_t, uint64_t> position, const double* values, std::string key);
+      void moveRow(uint32_t from, uint32_t to);
+      void popRow();
+   };
    std::vector<std::unique_ptr<Metric>> metrics;
-   std::array<std::vector<const Architecture*>, 7> architectures;
+   /// Per arch type, all candidates unless sorting
+   std::array<Table, 7> architectures;
    std::vector<const Architecture*> overallSort;
+   /// The metrics to sort by, together with whether to sort descending
+   std::vector<std::pair<bool, Metric*>> sortColumns;
+   /// The materialized metrics: first the sort columns in order, then the constrained metrics when filtering
+   std::vector<Metric*> columnMetrics;
+   /// When not empty, only the architectures that are not dominated in these metrics are retained, with whether larger values are better
+   std::vector<std::pair<bool, Metric*>> paretoColumns;
+   /// The positions of the pareto metrics in columnMetrics
+   std::vector<unsigned> paretoColumnIds;
+   /// Candidates whose formatted values of these metrics are equal are collapsed into one row
+   std::vector<Metric*> dedupColumns;
+   AlternativesMetric* alternativesMetric = nullptr;
+   /// Counts the filtered and printed architectures per type, when set
+   Stats* stats = nullptr;
+   size_t minPerArch = 0;
+   bool filterResults = false;
+   bool pruning = false;
+   /// Per arch type: the price of the worst retained candidate once the heap is full and the results are sorted by price
+   std::array<std::atomic<double>, 7> priceCutoff;
+   std::mutex mutex;
    //  std::vector<std::vector<std::unique_ptr<Metric>>> results;
    bool csvFormat;
    bool showHidden;
    bool hideAddedMetrics = false;
    std::string csvDelimiter;
 
-   MetricRegistry(bool csvFormat = false, bool showHidden = false, std::string csvDelimiter = ",") : csvFormat{csvFormat}, showHidden{showHidden}, csvDelimiter{csvDelimiter} {}
-   void sortAndTrunc(std::string_view sortColumn, size_t minPerArch);
-  //   void trunc(size_t minPerArch);
-   void filter();
+   MetricRegistry(bool csvFormat = false, bool showHidden = false, std::string csvDelimiter = ",");
+   /// Only keep the best minPerArch architectures per type, must be called before the first offer
+   void setSortOrder(std::string_view sortColumn, size_t minPerArch);
+   /// Drop architectures that violate a constraint of a metric as soon as they are offered
+   void setFilter(bool filter);
+   /// Only retain the Pareto-optimal architectures in these metrics (comma separated, prefixed with '-' when larger is better), instead of truncating
+   void setPareto(std::string_view columns);
+   /// Collapse equivalent architectures into the best one of them and add a column with the number of alternatives, must be called before the first offer
+   void setDedup(std::string_view keyColumns);
+   /// Let the builder skip candidates whose price lower bound is already worse than the retained ones
+   void setPruning(bool prune) { pruning = prune; }
+   void setStats(Stats* s) { stats = s; }
+   void offer(std::vector<std::unique_ptr<Architecture>>& batch, uint64_t batchId) override;
+   std::optional<Price> getPriceCutoff(ArchType t) const override;
+   bool enforcesConstraints() const override { return filterResults; }
+   /// Brings the retained architectures into their final order, sorting the types in parallel and merging their sorted runs
+   void sortAndTrunc(unsigned threads = 1);
+   bool isBetter(const Table& ta, uint32_t a, const Table& tb, uint32_t b) const;
+   /// Is a at least as good as b in all pareto metrics and better in at least one?
+   bool dominates(const Table& ta, uint32_t a, const Table& tb, uint32_t b) const;
 
    template <typename T, typename... Args>
    void add(Args&&... args);
 
    void printHeader(std::ostream& out);
-   void insert(const Architecture& a);
    void printArch(std::ostream& out, const Architecture& a, size_t id);
    void print(std::ostream& out);
+   /// Writes the sorted architectures as one typed array per printed metric, see the README for the layout
+   void printColumnar(std::ostream& out);
 
    void hideNextMetrics(bool hide) { hideAddedMetrics = hide; }
+
+   private:
+   /// A metric that is printed, with whether a csv delimiter follows it
+   struct PrintedColumn {
+      Metric* metric;
+      bool delimiter;
+      bool alignLeft;
+   };
+   std::vector<PrintedColumn> getPrintedColumns() const;
+   void formatHeader(infra::FormatBuffer& out, const std::vector<PrintedColumn>& columns);
+   void formatArch(infra::FormatBuffer& out, const std::vector<PrintedColumn>& columns, const Architecture& a);
+   void updateColumns();
+   std::vector<std::pair<bool, Metric*>> resolveColumns(std::string_view columns, std::string_view what) const;
+   /// Keeps the candidate (the last row of t) only if no row dominates it, and evicts the rows that it dominates
+   void insertIntoSkyline(Table& t, uint32_t candidate);
 };
 //--------------------------------------------------------------------------------
 template <typename T, typename... Args>
@@ -1,3 +1 @@
 #include "Metrics.hpp"
-
-uint64_t IdMetric::id = 0;
@@ -4,152 +4,213 @@
 #include "Architecture.hpp"
 #include "infra/Terminal.hpp"
 #include "infra/Math.hpp"
-#include <sstream>
 #include <string>
+#include <unordered_map>
 //--------------------------------------------------------------------------------
 struct PrimaryMetric : public Metric {
    PrimaryMetric() : Metric{"Primary", 10} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) { out << a.getPrimary().getDescription(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) { out << a.getPrimary().getDescription(); }
 };
 //--------------------------------------------------------------------------------
 struct IdMetric : public Metric {
-   static uint64_t id;
+   uint64_t id = 0;
    IdMetric() : Metric{"id", 3} {}
-   void formatValue(std::ostream& out, const Architecture&, bool) { out << id++; }
+   void formatValue(infra::FormatBuffer& out, const Architecture&, bool) { out << id++; }
   //  std::partial_ordering compare(const Architecture& a, const Architecture& b
 };
 //--------------------------------------------------------------------------------
 struct SecondaryMetric : public Metric {
    SecondaryMetric() : Metric{"numSec"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getSecondaries().getCount(); }
-   std::partial_ordering compare(const Architecture& a, const Architecture& b) const override { return a.getSecondaries().getCount() <=> b.getSecondaries().getCount(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getSecondaries().getCount(); }
+   double getValue(const Architecture& a) const override { return a.getSecondaries().getCount(); }
+   std::string_view getUnit() const override { return "count"; }
 };
 //--------------------------------------------------------------------------------
 struct PrimaryBufferCache : public Metric {
   PrimaryBufferCache() : Metric{"PrimCache"} {}
-  void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getBufferCacheSize(), raw); }
+  void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getBufferCacheSize(), raw); }
+  double getValue(const Architecture& a) const override { return a.getPrimary().getBufferCacheSize(); }
+  std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct PrimaryBufferCacheHitrate : public Metric {
   PrimaryBufferCacheHitrate() : Metric{"PriCaHit"} {}
-  void formatValue(std::ostream& out, const Architecture& a, bool /*raw*/) override { out << a.getPrimary().probCacheHit(); }
+  void formatValue(infra::FormatBuffer& out, const Architecture& a, bool /*raw*/) override { out << a.getPrimary().probCacheHit(); }
+  double getValue(const Architecture& a) const override { return a.getPrimary().probCacheHit(); }
+  std::string_view getUnit() const override { return "ratio"; }
 };
 //--------------------------------------------------------------------------------
 struct TypeMetric : public Metric {
    TypeMetric() : Metric{"Type", 9} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getTypeName(); }
-   std::partial_ordering compare(const Architecture& a, const Architecture& b) const override { return a.getTypeName() == b.getTypeName() ? std::partial_ordering::equivalent : a.getTypeName() < b.getTypeName() ? std::partial_ordering::less :
-                                                                                                                                                                                                                    std::partial_ordering::greater; }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getTypeName(); }
+   /// Sorts by name, so the value is the rank of the name among all types
+   double getValue(const Architecture& a) const override {
+      unsigned rank = 0;
+      for (auto t = 0u; t <= static_cast<unsigned>(ArchType::Dynamic); ++t) {
+         if (archTypeToName(static_cast<ArchType>(t)) < a.getTypeName()) ++rank;
+      }
+      return rank;
+   }
 };
 //--------------------------------------------------------------------------------
 struct CPUVendorMetric : public Metric {
    CPUVendorMetric() : Metric{"CPUVendor", 9} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPrimary().getCPUVendor(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPrimary().getCPUVendor(); }
 };
 //--------------------------------------------------------------------------------
 struct StorageMetric : public Metric {
    StorageMetric() : Metric{"StorageDesc", 30} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPageService().getDescription(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPageService().getDescription(); }
 };
 //--------------------------------------------------------------------------------
 struct StorageDevice : public Metric {
    StorageDevice() : Metric{"StorageDev", 4} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPageService().getDeviceType(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPageService().getDeviceType(); }
 };
 //--------------------------------------------------------------------------------
 struct LogServiceMetric : public Metric {
    LogServiceMetric() : Metric{"LogDesc", 15} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getLogService().getDescription(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getLogService().getDescription(); }
 };
 //--------------------------------------------------------------------------------
 struct LogServicePrice : public Metric {
    LogServicePrice() : Metric{"LogSvcPrice"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override {
+   static Price get(const Architecture& a) {
       auto price = Price::zero;
       if (!a.getPageService().containsLogService()) {
          price = a.getLogService().getPrice();
      }
-     out << price;
+     return price;
    }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << get(a); }
+   double getValue(const Architecture& a) const override { return get(a).value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct PageServicePrice : public Metric {
    PageServicePrice() : Metric{"PageSvcPrice"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPageService().getPrice(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPageService().getPrice(); }
+   double getValue(const Architecture& a) const override { return a.getPageService().getPrice().value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct PrimaryPrice : public Metric {
    PrimaryPrice() : Metric{"PrimPrice"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPrimary().getPrice(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPrimary().getPrice(); }
+   double getValue(const Architecture& a) const override { return a.getPrimary().getPrice().value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct EBSPrice : public Metric {
    EBSPrice() : Metric{"EBSPrice"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPrimary().getEBSPrice(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPrimary().getEBSPrice(); }
+   double getValue(const Architecture& a) const override { return a.getPrimary().getEBSPrice().value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct SecondariesPrice : public Metric {
    SecondariesPrice() : Metric{"SecPrice"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getSecondaries().getPrice(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getSecondaries().getPrice(); }
+   double getValue(const Architecture& a) const override { return a.getSecondaries().getPrice().value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct S3Price : public Metric {
    S3Price() : Metric{"S3Price"} {}
    static Price get(const Architecture& a) { return a.getS3Price(); }
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << get(a); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << get(a); }
+   double getValue(const Architecture& a) const override { return get(a).value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct NetworkPrice : public Metric {
    NetworkPrice() : Metric{"NetworkPrice"} {}
    static Price get(const Architecture& a) { return a.getNetworkPrice(); }
-   void formatValue(std::ostream& out, const Architecture& a, bool) { out << get(a); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) { out << get(a); }
+   double getValue(const Architecture& a) const override { return get(a).value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct TotalPrice : public Metric {
    TotalPrice() : Metric{"TotalPrice"} {}
    static Price getPrice(const Architecture& a) { return a.getTotalPrice(); }
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << getPrice(a); }
-   std::partial_ordering compare(const Architecture& a, const Architecture& b) const override { return getPrice(a) <=> getPrice(b); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << getPrice(a); }
+   double getValue(const Architecture& a) const override { return getPrice(a).value; }
+   std::string_view getUnit() const override { return "USD/h"; }
 };
 //--------------------------------------------------------------------------------
 struct DurabilityMetric : public Metric {
    Durability target;
    DurabilityMetric(Durability t) : Metric{"Durability", 8}, target{t} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getDurability(); }
-   std::partial_ordering compare(const Architecture& a, const Architecture& b) const override { return a.getDurability() <=> b.getDurability(); }
-   bool shouldExclude(const Architecture& a) const override { return a.getDurability() < target; }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getDurability(); }
+   double getValue(const Architecture& a) const override { return a.getDurability().numericValue; }
+   std::string_view getUnit() const override { return "probability"; }
+   bool hasConstraint() const override { return true; }
+   bool shouldExclude(double value) const override { return value < target.numericValue; }
 };
 //--------------------------------------------------------------------------------
 struct DatasetSize : public Metric {
    uint64_t size;
    DatasetSize(uint64_t size) : Metric{"DataSize"}, size{size} {}
-   void formatValue(std::ostream& out, const Architecture&, bool raw) { formatByte(out, size, raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture&, bool raw) { formatByte(out, size, raw); }
+   double getValue(const Architecture&) const override { return size; }
+   std::string_view getUnit() const override { return "bytes"; }
+};
+//--------------------------------------------------------------------------------
+/// A parameter of the run, e.g., to tell the grid points of a sweep apart
+struct ParameterValue : public Metric {
+   std::string value;
+   ParameterValue(const std::string& name, std::string value) : Metric{name}, value{std::move(value)} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture&, bool) override { out << value; }
+};
+//--------------------------------------------------------------------------------
+/// The number of equivalent candidates that were collapsed into the row, filled by the registry when deduplicating
+struct AlternativesMetric : public Metric {
+   std::unordered_map<const Architecture*, uint64_t> counts;
+   AlternativesMetric() : Metric{"Alts", 4} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override {
+      auto it = counts.find(&a);
+      out << (it != counts.end() ? it->second : 0);
+   }
+   double getValue(const Architecture& a) const override {
+      auto it = counts.find(&a);
+      return it != counts.end() ? it->second : 0;
+   }
+   std::string_view getUnit() const override { return "count"; }
 };
 //--------------------------------------------------------------------------------
 struct StorageCapacity : public Metric {
    StorageCapacity() : Metric{"Storage"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) { formatByte(out, a.getPageService().getTotalSize(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) { formatByte(out, a.getPageService().getTotalSize(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPageService().getTotalSize(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct S3Storage : public Metric {
    S3Storage() : Metric{"S3Storage"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) { formatByte(out, a.getS3Storage(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) { formatByte(out, a.getS3Storage(), raw); }
+   double getValue(const Architecture& a) const override { return a.getS3Storage(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct PrimaryRandomLookupTx : public Metric {
    PrimaryRandomLookupTx() : Metric{"PrimLookups", 10} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getPrimaryRandomLookupTx(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getPrimaryRandomLookupTx(); }
+   double getValue(const Architecture& a) const override { return a.getPrimaryRandomLookupTx().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
 };
 //--------------------------------------------------------------------------------
 struct SecondariesRandomLookupTx : public Metric {
    SecondariesRandomLookupTx() : Metric{"SecLookups"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getSecondariesRandomLookupTx(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getSecondariesRandomLookupTx(); }
+   double getValue(const Architecture& a) const override { return a.getSecondariesRandomLookupTx().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
 };
 //--------------------------------------------------------------------------------
 struct RandomLookupTx : public Metric {
    Rate target;
    RandomLookupTx(Rate target) : Metric{"Lookups", 9}, target{target} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getRandomLookupTx(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getRandomLookupTx(); }
    const char* getColor(const Architecture& a) const override {
       auto v = a.getRandomLookupTx();
       if (v == target) {
@@ -158,13 +219,16 @@ struct RandomLookupTx : public Metric {
          return infra::Terminal::NOCOLOR;
       }
    }
-   bool shouldExclude(const Architecture& a) const override { return a.getRandomLookupTx() < target; }
+   double getValue(const Architecture& a) const override { return a.getRandomLookupTx().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
+   bool hasConstraint() const override { return true; }
+   bool shouldExclude(double value) const override { return value < target.rate; }
 };
 //--------------------------------------------------------------------------------
 struct RandomUpdateTx : public Metric {
    Rate target;
    RandomUpdateTx(Rate target) : Metric{"Updates"}, target{target} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getRandomUpdateTx(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getRandomUpdateTx(); }
    const char* getColor(const Architecture& a) const override {
       auto v = a.getRandomUpdateTx();
       if (v == target) {
@@ -173,61 +237,131 @@ struct RandomUpdateTx : public Metric {
          return infra::Terminal::NOCOLOR;
       }
    }
-   bool shouldExclude(const Architecture& a) const override { return a.getRandomUpdateTx() < target; }
+   double getValue(const Architecture& a) const override { return a.getRandomUpdateTx().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
+   bool hasConstraint() const override { return true; }
+   bool shouldExclude(double value) const override { return value < target.rate; }
 };
 //--------------------------------------------------------------------------------
 struct PageWriteVolume : public Metric {
    PageWriteVolume() : Metric{"PageWriteVol"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPageService().getWriteVolume(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPageService().getWriteVolume(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPageService().getWriteVolume(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct PageReadVolume : public Metric {
    PageReadVolume() : Metric{"PageReadVol"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPageService().getReadVolume(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPageService().getReadVolume(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPageService().getReadVolume(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 // On the primary
 struct NetworkInVolume : public Metric {
    NetworkInVolume() : Metric{"PrimNetIn"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getNetworkInVolume(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getNetworkInVolume(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPrimary().getNetworkInVolume(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 // On the primary
 struct NetworkOutVolume : public Metric {
    NetworkOutVolume() : Metric{"PrimNetOut"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getNetworkOutVolume(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getNetworkOutVolume(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPrimary().getNetworkOutVolume(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct InterAZTraffic: public Metric {
    InterAZTraffic() : Metric{"InterAZ"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getInterAZTraffic(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getInterAZTraffic(), raw); }
+   double getValue(const Architecture& a) const override { return a.getInterAZTraffic(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct LogVolume : public Metric {
    LogVolume() : Metric{"LogVolume"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getLogVolume(), raw); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatByte(out, a.getPrimary().getLogVolume(), raw); }
+   double getValue(const Architecture& a) const override { return a.getPrimary().getLogVolume(); }
+   std::string_view getUnit() const override { return "bytes"; }
 };
 //--------------------------------------------------------------------------------
 struct S3Gets : public Metric {
    S3Gets() : Metric{"S3GET"} {}
-  void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getS3GETRate(); }
+  void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getS3GETRate(); }
+  double getValue(const Architecture& a) const override { return a.getS3GETRate().rate; }
+  std::string_view getUnit() const override { return "ops/s"; }
 };
 //--------------------------------------------------------------------------------
 struct S3Puts : public Metric {
    S3Puts() : Metric{"S3PUT"} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getS3PUTRate(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getS3PUTRate(); }
+   double getValue(const Architecture& a) const override { return a.getS3PUTRate().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
 };
 //--------------------------------------------------------------------------------
 struct OpLatencyMetric : public Metric {
    Latency target;
    OpLatencyMetric(Latency latencyLimitNs) : Metric{"OpLatency", 7}, target{latencyLimitNs} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getOpLatency(); }
-   bool shouldExclude(const Architecture& a) const override { return a.getOpLatency().avg > target.avg; }
-   std::partial_ordering compare(const Architecture& a, const Architecture& b) const override { return a.getOpLatency().avg.count() <=> b.getOpLatency().avg.count(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getOpLatency(); }
+   double getValue(const Architecture& a) const override { return a.getOpLatency().avg.count(); }
+   std::string_view getUnit() const override { return "ns"; }
+   bool hasConstraint() const override { return true; }
+   bool shouldExclude(double value) const override { return value > target.avg.count(); }
 };
 //--------------------------------------------------------------------------------
 struct CommitLatencyMetric : public Metric {
    CommitLatencyMetric() : Metric{"CommitLatency", 7} {}
-   void formatValue(std::ostream& out, const Architecture& a, bool) override { out << a.getCommitLatency(); }
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getCommitLatency(); }
+   double getValue(const Architecture& a) const override { return a.getCommitLatency().avg.count(); }
+   std::string_view getUnit() const override { return "ns"; }
+};
+//--------------------------------------------------------------------------------
+struct FailoverTimeMetric : public Metric {
+   FailoverTimeMetric() : Metric{"FailoverTime", 8} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getFailoverTime(); }
+   double getValue(const Architecture& a) const override { return a.getFailoverTime().value; }
+   std::string_view getUnit() const override { return "s"; }
+};
+//--------------------------------------------------------------------------------
+/// The resource that limits the throughput first
+struct BottleneckMetric : public Metric {
+   BottleneckMetric() : Metric{"Bottleneck", 10} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << resourceToName(a.getBottleneck()); }
+};
+//--------------------------------------------------------------------------------
+/// The demand of the required workload on one resource relative to its capacity, above one when the resource is overloaded
+struct UtilizationMetric : public Metric {
+   Resource resource;
+   UtilizationMetric(Resource r) : Metric{resourceToName(r) + "%", std::max<uint64_t>(resourceToName(r).size() + 1, 6)}, resource{r} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override { formatPercentage(out, a.getUtilization(resource), raw); }
+   double getValue(const Architecture& a) const override { return a.getUtilization(resource); }
+   std::string_view getUnit() const override { return "ratio"; }
+};
+//--------------------------------------------------------------------------------
+/// The largest transaction rate that the architecture sustains at the required update ratio
+struct MaxTransactionsMetric : public Metric {
+   MaxTransactionsMetric() : Metric{"MaxTx", 10} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool) override { out << a.getMaxTransactions(); }
+   double getValue(const Architecture& a) const override { return a.getMaxTransactions().rate; }
+   std::string_view getUnit() const override { return "ops/s"; }
+};
+//--------------------------------------------------------------------------------
+/// The max transactions relative to the required ones, the architectures with less headroom than the target are excluded
+struct HeadroomMetric : public Metric {
+   double target;
+   HeadroomMetric(double target) : Metric{"Headroom", 8}, target{target} {}
+   void formatValue(infra::FormatBuffer& out, const Architecture& a, bool raw) override {
+      if (raw) {
+         out << a.getHeadroom();
+      } else {
+         out.appendFixed(a.getHeadroom(), 2) << "x";
+      }
+   }
+   double getValue(const Architecture& a) const override { return a.getHeadroom(); }
+   std::string_view getUnit() const override { return "factor"; }
+   bool hasConstraint() const override { return true; }
+   bool shouldExclude(double value) const override { return value < target; }
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+#include "NodeCatalog.hpp"
+#include "ArchitectureBuilder.hpp"
+#include "infra/CSV.hpp"
+#include "infra/File.hpp"
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+//--------------------------------------------------------------------------------
+using namespace std;
+using namespace infra;
+//--------------------------------------------------------------------------------
+static constexpr char magic[8] = {'C', 'C', 'N', 'O', 'D', 'E', 'S', '\0'};
+//--------------------------------------------------------------------------------
+struct SnapshotHeader {
+   char magic[8];
+   uint32_t version;
+   /// Guards against layout changes of the resources that did not bump the version
+   uint32_t recordSize;
+   uint64_t csvHash;
+   uint64_t numNodes;
+   uint64_t stringBytes;
+};
+//--------------------------------------------------------------------------------
+/// A prepared node, the strings are offsets into the interned string section that follows the records
+struct NodeRecord {
+   uint32_t nameOffset, nameLength;
+   uint32_t vendorOffset, vendorLength;
+   /// The hourly price before the EC2 discount, so that one snapshot serves all discounts
+   double price;
+   uint64_t cpuCount;
+   double cpuSpeed;
+   Memory memory;
+   Network network;
+   InstanceStorage instanceStorage;
+   MachineEBSLimits machineEbs;
+};
+static_assert(is_trivially_copyable_v<NodeRecord>);
+// The records are read in place from the page aligned mapping
+static_assert(sizeof(SnapshotHeader) % alignof(NodeRecord) == 0);
+//--------------------------------------------------------------------------------
+static uint64_t hashBytes(string_view data) {
+   // FNV-1a
+   uint64_t hash = 0xcbf29ce484222325ull;
+   for (unsigned char c : data) {
+      hash = (hash ^ c) * 0x100000001b3ull;
+   }
+   return hash;
+}
+//--------------------------------------------------------------------------------
+static optional<vector<Node>> readSnapshot(const string& path, uint64_t csvHash, double ec2Discount) {
+   if (!File{path}.exists()) return nullopt;
+   File file{path, File::AccessMode::ReadOnly};
+   file.open(OpenMode::Open);
+   MappedFile mapped{file};
+   auto data = mapped.view();
+
+   SnapshotHeader header;
+   if (data.size() < sizeof(header)) return nullopt;
+   memcpy(&header, data.data(), sizeof(header));
+   if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != NodeCatalog::version || header.recordSize != sizeof(NodeRecord) || header.csvHash != csvHash) return nullopt;
+   if (data.size() != sizeof(header) + header.numNodes * sizeof(NodeRecord) + header.stringBytes) return nullopt;
+
+   auto strings = data.substr(sizeof(header) + header.numNodes * sizeof(NodeRecord));
+   auto getString = [&](uint32_t offset, uint32_t length) -> optional<string> {
+      if (uint64_t{offset} + length > strings.size()) return nullopt;
+      return string{strings.substr(offset, length)};
+   };
+   auto records = reinterpret_cast<const NodeRecord*>(data.data() + sizeof(header));
+   vector<Node> nodes;
+   nodes.reserve(header.numNodes);
+   for (uint64_t i = 0; i < header.numNodes; ++i) {
+      auto& r = records[i];
+      auto name = getString(r.nameOffset, r.nameLength);
+      auto vendor = getString(r.vendorOffset, r.vendorLength);
+      if (!name || !vendor) return nullopt;
+      auto price = Price::hourly(r.price * (1.0 - ec2Discount));
+      nodes.push_back(Node{std::move(*name), CPU{r.cpuCount, r.cpuSpeed, std::move(*vendor)}, r.memory, r.network, price, r.instanceStorage, r.machineEbs});
+   }
+   return nodes;
+}
+//--------------------------------------------------------------------------------
+static void writeSnapshot(const string& path, uint64_t csvHash, const vector<Node>& nodes) {
+   vector<NodeRecord> records;
+   records.reserve(nodes.size());
+   string strings;
+   unordered_map<string, uint32_t> interned;
+   auto intern = [&](const string& s) {
+      auto [it, inserted] = interned.try_emplace(s, strings.size());
+      if (inserted) strings += s;
+      return it->second;
+   };
+   for (auto& n : nodes) {
+      records.push_back(NodeRecord{
+         .nameOffset = intern(n.name),
+         .nameLength = static_cast<uint32_t>(n.name.size()),
+         .vendorOffset = intern(n.cpu.vendor),
+         .vendorLength = static_cast<uint32_t>(n.cpu.vendor.size()),
+         .price = n.price.value,
+         .cpuCount = n.cpu.count,
+         .cpuSpeed = n.cpu.speed,
+         .memory = n.memory,
+         .network = n.network,
+         .instanceStorage = n.instanceStorage,
+         .machineEbs = n.machineEbs,
+      });
+   }
+   SnapshotHeader header{};
+   memcpy(header.magic, magic, sizeof(magic));
+   header.version = NodeCatalog::version;
+   header.recordSize = sizeof(NodeRecord);
+   header.csvHash = csvHash;
+   header.numNodes = records.size();
+   header.stringBytes = strings.size();
+
+   // Write to a temporary file first, so that concurrent runs never map a partial snapshot
+   auto tmpPath = path + ".tmp" + to_string(::getpid());
+   File file{tmpPath, File::AccessMode::WriteOnly};
+   file.open(OpenMode::Overwrite);
+   file.write(&header, sizeof(header));
+   file.write(records.data(), records.size() * sizeof(NodeRecord));
+   file.write(strings.data(), strings.size());
+   file.close();
+   file.move(path);
+}
+//--------------------------------------------------------------------------------
+vector<Node> NodeCatalog::load(const string& csvPath, double ec2Discount, bool useSnapshot, Stats* stats) {
+   File csvFile{csvPath, File::AccessMode::ReadOnly};
+   csvFile.open(OpenMode::Open);
+   MappedFile csv{csvFile};
+   auto csvHash = hashBytes(csv.view());
+   auto snapshotPath = getSnapshotPath(csvPath);
+
+   optional<vector<Node>> nodes;
+   if (useSnapshot) {
+      Stats::Phase phase{stats, "readSnapshot"};
+      try {
+         nodes = readSnapshot(snapshotPath, csvHash, ec2Discount);
+      } catch (const exception& e) {
+         cerr << "ignoring node snapshot: " << e.what() << "\n";
+      }
+   }
+   if (!nodes) {
+      VantageCSV vantageCSV;
+      {
+         Stats::Phase phase{stats, "csvParse"};
+         CSVReader reader{csv.view()};
+         vantageCSV.parse(reader);
+      }
+      {
+         Stats::Phase phase{stats, "loadNodes"};
+         // The snapshot stores the prices without discount
+         nodes = ArchitectureBuilder::loadNodes(vantageCSV, 0.0);
+      }
+      if (useSnapshot) {
+         Stats::Phase phase{stats, "writeSnapshot"};
+         try {
+            writeSnapshot(snapshotPath, csvHash, *nodes);
+         } catch (const exception& e) {
+            cerr << "cannot write node snapshot: " << e.what() << "\n";
+         }
+      }
+      for (auto& n : *nodes) {
+         n.price = Price::hourly(n.price.value * (1.0 - ec2Discount));
+      }
+   }
+   if (stats) {
+      stats->instances = nodes->size();
+   } else {
+      cerr << "num instances: " << nodes->size() << "\n";
+   }
+   return std::move(*nodes);
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,17 @@
+#pragma once
+#include "Resources.hpp"
+#include "Stats.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+//--------------------------------------------------------------------------------
+/// Loads the nodes of the instance csv through a binary snapshot of the prepared node table (<csv>.nodes).
+/// The snapshot is keyed by the hash of the csv and rebuilt whenever the csv or the snapshot format changes.
+struct NodeCatalog {
+   /// Bump whenever Node, its resources, or their derivation from the csv change
+   static constexpr uint32_t version = 1;
+
+   static std::vector<Node> load(const std::string& csvPath, double ec2Discount, bool useSnapshot = true, Stats* stats = nullptr);
+   static std::string getSnapshotPath(const std::string& csvPath) { return csvPath + ".nodes"; }
+};
+//--------------------------------------------------------------------------------
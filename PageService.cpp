@@ -38,14 +38,14 @@ InstanceStoragePageService::InstanceStoragePageService(const Parameter& p2, Prim
 }
 //--------------------------------------------------------------------------------
 unique_ptr<InMemoryPageService> InMemoryPageService::assemble(const Parameter& p, Primary& prim) {
-   if (prim.n.memory.getTotalSize() < p.getDataSize()) return nullptr;
+   if (prim.n.memory.getTotalSize() < p.getDataSize()) return reject(Rejection::Memory);
    return make_unique<InMemoryPageService>(p, prim);
 }
 //--------------------------------------------------------------------------------
-unique_ptr<Ec2PageService> Ec2PageService::assemble(const Parameter& p, Primary& prim, Node pageNode, Latency targetLatency, [[maybe_unused]] unsigned replication, bool useRbpex) {
+unique_ptr<Ec2PageService> Ec2PageService::assemble(const Parameter& p, Primary& prim, const Node& pageNode, Latency targetLatency, [[maybe_unused]] unsigned replication, bool useRbpex) {
    assert(pageNode.instanceStorage.devices > 0.0);
 
-   double storageScale = (1.0 * replication * p.getDataSize()) / (pageNode.instanceStorage.getUsableSize() + (useRbpex ? pageNode.memory.getTotalSize() : 0));
+   double storageScale = getStorageFraction(p, pageNode, replication, useRbpex);
 
    // A page server reads a log record from the network for every log record that gets applied
    double networkReadScale = (p.requiredUpdateOps * replication * p.getLogRecordSize()) / pageNode.network.getReadLimit();
@@ -82,6 +82,10 @@ unique_ptr<Ec2PageService> Ec2PageService::assemble(const Parameter& p, Primary&
    return make_unique<Ec2PageService>(p, pageNode, pageNodeFraction, useRbpex);
 }
 //--------------------------------------------------------------------------------
+double Ec2PageService::getStorageFraction(const Parameter& p, const Node& pageNode, unsigned replication, bool useRbpex) {
+   return (1.0 * replication * p.getDataSize()) / (pageNode.instanceStorage.getUsableSize() + (useRbpex ? pageNode.memory.getTotalSize() : 0));
+}
+//--------------------------------------------------------------------------------
 string Ec2PageService::getDescription() const {
   stringstream res;
   res << setprecision(2) << pageNodeFraction;
@@ -148,16 +152,24 @@ unique_ptr<EBSPageService> EBSPageService::assemble(const Parameter& parameter,
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
 Durability CombinedPageServiceLog::getDurability() const {
+  return computeDurability(n);
+}
+//--------------------------------------------------------------------------------
+Durability CombinedPageServiceLog::computeDurability(const Node& n) {
   // The aurora paper claims they can repair 10GB in 10 sec on a 10Gbit NIC.
   // We just take those 10sec for now
   return Durability::calculateDurability(replication, n.getAvailability().numericValue, 10, 3 /*we always need to maintain read quorum to be durable*/);
 }
 //--------------------------------------------------------------------------------
-unique_ptr<CombinedPageServiceLog> CombinedPageServiceLog::assemble(const Parameter& p, Primary& prim, Node storageNode, Latency targetLatency) {
+double CombinedPageServiceLog::getStorageFraction(const Parameter& p, const Node& storageNode) {
    double grossStorageSize = (p.getDataSize() + p.indexSize()) * AuroraLike::dataReplication + p.getRequiredLogStorage() * AuroraLike::logReplication;
-   assert(storageNode.instanceStorage);
    // No divRoundUp here, we model a multi-tenant service!
-   double datasetScale = grossStorageSize / storageNode.instanceStorage.getUsableSize();
+   return grossStorageSize / storageNode.instanceStorage.getUsableSize();
+}
+//--------------------------------------------------------------------------------
+unique_ptr<CombinedPageServiceLog> CombinedPageServiceLog::assemble(const Parameter& p, Primary& prim, const Node& storageNode, Latency targetLatency) {
+   assert(storageNode.instanceStorage);
+   double datasetScale = getStorageFraction(p, storageNode);
 
    Latency network = Latency::combine({{p.getSameAZRatio(), SameDatacenter::latency}, {p.getRemoteAZRatio(), SameRegion::latency}});
    double minRequiredCacheHitRate = Latency::getRatio(targetLatency - network.asAvg(), Memory::readLatency, InstanceStorage::readLatency);
@@ -113,12 +113,12 @@ struct S3PageService : public PageService {
 //--------------------------------------------------------------------------------
 struct Ec2PageService : public PageService {
    /// The node type for the page service
-   Node pageNode;
+   const Node& pageNode;
    double pageNodeFraction;
    bool useRbpex;
 
    public:
-   Ec2PageService(const Parameter& p, Node pageNode, double pageNodeFraction, bool useRbpex) : PageService{p}, pageNode{pageNode}, pageNodeFraction{pageNodeFraction}, useRbpex{useRbpex} {}
+   Ec2PageService(const Parameter& p, const Node& pageNode, double pageNodeFraction, bool useRbpex) : PageService{p}, pageNode{pageNode}, pageNodeFraction{pageNodeFraction}, useRbpex{useRbpex} {}
    Price getPrice() const override { return pageNodeFraction * pageNode.price; }
   uint64_t getTotalSize() const override { return pageNodeFraction * (pageNode.instanceStorage.getUsableSize() + (useRbpex ? pageNode.memory.getTotalSize() : 0)); }
    std::string getDescription() const override;
@@ -131,17 +131,19 @@ struct Ec2PageService : public PageService {
    double getPageNodeCacheMiss() const;
    Latency getOpLatency() const override;
 
-   static std::unique_ptr<Ec2PageService> assemble(const Parameter& p, Primary& prim, Node pageNode, Latency targetLatency, unsigned replication, bool userbpex = true);
+   static std::unique_ptr<Ec2PageService> assemble(const Parameter& p, Primary& prim, const Node& pageNode, Latency targetLatency, unsigned replication, bool userbpex = true);
+   /// The fraction of the page node needed just to store the data, a lower bound for the fraction chosen by assemble
+   static double getStorageFraction(const Parameter& p, const Node& pageNode, unsigned replication, bool useRbpex);
 };
 //--------------------------------------------------------------------------------
 // Models Aurora
 struct CombinedPageServiceLog : public PageService, public LogService {
    static constexpr unsigned replication = 6;
 
-   Node n;
+   const Node& n;
    double fraction;
 
-   CombinedPageServiceLog(const Parameter& p, Node n, double frac) : PageService(p), LogService(p), n{n}, fraction{frac} {}
+   CombinedPageServiceLog(const Parameter& p, const Node& n, double frac) : PageService(p), LogService(p), n{n}, fraction{frac} {}
    void init(double primaryCacheMiss, Latency targetOpLatency);
    bool containsLogService() const override { return true; }
    uint64_t getTotalSize() const override { return fraction * n.instanceStorage.getUsableSize(); }
@@ -155,12 +157,15 @@ struct CombinedPageServiceLog : public PageService, public LogService {
    Latency getOpLatency() const override;
    double getPageNodeCacheMiss() const;
    Durability getDurability() const override;
+   static Durability computeDurability(const Node& storageNode);
    Rate getUpdateOps() const override;
    Rate getPageReadOps() const override;
   // No write back of materialized pages, thus unlimited
    Rate getPageWriteOps() const override { return Rate::unlimited; }
 
-   static std::unique_ptr<CombinedPageServiceLog> assemble(const Parameter& p, Primary& prim, Node pageNode, Latency targetOpLatency);
+   static std::unique_ptr<CombinedPageServiceLog> assemble(const Parameter& p, Primary& prim, const Node& pageNode, Latency targetOpLatency);
+   /// The fraction of the storage node needed just to store the replicated data and log, a lower bound for the fraction chosen by assemble
+   static double getStorageFraction(const Parameter& p, const Node& storageNode);
 };
 //--------------------------------------------------------------------------------
 struct CombinedPageServiceLogWrapper : public LogService {
@@ -22,19 +22,29 @@ RemoteBlockDevice::RemoteBlockDevice(Parameter p, Primary prim, EBSAllotment ebs
    auto remainingIops = totalIOPS - updates * ebsScale;
    lookups = vmin(cpuLookups, remainingIops / (readsPerLookup + writesPerLookup), parameter.requiredLookupOps);
 
+   // Utilization at the required rate
+   auto ops = parameter.requiredOps();
+   setUtilization(Resource::CPU, ops, cpuUpdates);
+   setEBSUtilization();
+
    primary.logVolume = updates.rate * parameter.getAriesLogRecordSize();
 
    commitLatency = EBS::writeLatency;
-   opLatency = Latency::combine({{primary.probCacheMiss(), EBS::readLatency}, {primary.probCacheHit(), Memory::readLatency}});
+   opLatency = computeOpLatency(primary);
+   addQueueingDelays({{primary.probCacheMiss(), Resource::EBS, EBS::readLatency}}, {{Resource::EBS, EBS::writeLatency}});
+}
+//--------------------------------------------------------------------------------
+Latency RemoteBlockDevice::computeOpLatency(const Primary& primary) {
+   return Latency::combine({{primary.probCacheMiss(), EBS::readLatency}, {primary.probCacheHit(), Memory::readLatency}});
 }
 //--------------------------------------------------------------------------------
 Durability RemoteBlockDevice::getDurability() const { return log.getDurability(); }
 //--------------------------------------------------------------------------------
-unique_ptr<RemoteBlockDevice> RemoteBlockDevice::assemble(const Parameter& p2, Node n, EBS::Type t) {
+unique_ptr<RemoteBlockDevice> RemoteBlockDevice::assemble(const Parameter& p2, const PrimaryPrototype& prototype, EBS::Type t) {
    auto p = p2;
    assert(p.indexOnlyTables);
    p.walIncludesUndo = true;
-   Primary primary{p, n};
+   Primary primary{prototype.plain, p};
 
    // Create an EBS device that fits both the database and the log
    auto size = p.getDataSize() + p.getRequiredAriesLogStorage();
@@ -48,7 +58,7 @@ unique_ptr<RemoteBlockDevice> RemoteBlockDevice::assemble(const Parameter& p2, N
    auto ebs = primary.addEBSCapacity(t, size, requiredIOPS, requiredBandwidth, max(p.pageSize, p.tupleSize));
    if (!ebs) return {};
    assert(size <= ebs->size);
-   if (p.requiredOps() > primary.n.cpu.getOps(p.cpuCost)) return {};
+   if (p.requiredOps() > primary.n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
    return make_unique<RemoteBlockDevice>(p, primary, *ebs);
 }
 //--------------------------------------------------------------------------------
@@ -26,6 +26,8 @@ class RemoteBlockDevice : public Architecture {
 
    uint64_t getInterAZTraffic() const override { return 0; }
 
-   static std::unique_ptr<RemoteBlockDevice> assemble(const Parameter& p, Node n, EBS::Type t);
+   static std::unique_ptr<RemoteBlockDevice> assemble(const Parameter& p, const PrimaryPrototype& prototype, EBS::Type t);
+   /// Only depends on the cache hit rate, so it is known before assembly
+   static Latency computeOpLatency(const Primary& primary);
 };
 //--------------------------------------------------------------------------------
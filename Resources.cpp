@@ -3,8 +3,9 @@
 #include "infra/Parser.hpp"
 #include "infra/Math.hpp"
 #include <cassert>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <cmath>
+#include <ostream>
 #include <string_view>
 //--------------------------------------------------------------------------------
 using namespace std;
@@ -42,6 +43,17 @@ Latency Latency::combine(initializer_list<pair<double,Latency>> weights) {
   return result;
 }
 //--------------------------------------------------------------------------------
+Latency Latency::queueing(double utilization, double servers, duration<double> serviceTime, bool deterministic) {
+  if (utilization <= 0 || serviceTime.count() <= 0) return Latency{0ns};
+  if (utilization >= 1) return infinite();
+  servers = std::max(servers, 1.0);
+  // Allen-Cunneen with exponential arrivals: the M/M/c wait scaled by (1 + cs^2) / 2 for the variability of the service
+  auto variability = deterministic ? 0.5 : 1.0;
+  auto wait = serviceTime * variability * pow(utilization, sqrt(2 * (servers + 1)) - 1) / (servers * (1 - utilization));
+  if (wait >= infinite().avg) return infinite();
+  return Latency{0ns, duration_cast<nanoseconds>(wait), duration_cast<nanoseconds>(wait)};
+}
+//--------------------------------------------------------------------------------
 Latency Latency::deduce(Latency target, initializer_list<pair<double, Latency>> weights) {
 
   // Example target is 40us, and you already have 0.2 * 20us and 0.1 * 80us
@@ -70,7 +82,7 @@ double Latency::getRatio(Latency target, Latency lower, Latency higher) {
   return result;
 }
 //--------------------------------------------------------------------------------
-static ostream& printTimestampWithUnit(ostream& out, chrono::nanoseconds val) {
+static void printTimestampWithUnit(FormatBuffer& out, chrono::nanoseconds val) {
    static constexpr string_view units[] = {"ns","us","ms","s"};
 
    uint64_t temp = val.count();
@@ -86,19 +98,16 @@ static ostream& printTimestampWithUnit(ostream& out, chrono::nanoseconds val) {
 
    double result = (double)val.count()/finalDivisor;
    assert(orders <= 6);
-   stringstream ss;
    int64_t result_int = result;
    if (result_int == result) {
-      ss << result_int;
+      out << result_int;
    } else {
-      ss << std::fixed << std::setprecision(1) << result;
+      out.appendFixed(result, 1);
    }
-   ss << units[orders];
-   out << ss.str();
-   return out;
+   out << units[orders];
 }
 //--------------------------------------------------------------------------------
-ostream& operator<<(ostream& out, const Latency& p) {
+FormatBuffer& operator<<(FormatBuffer& out, const Latency& p) {
   if (Latency::machineReadable) {
     out << p.avg.count();
   } else if(Latency::verbose) {
@@ -114,8 +123,14 @@ ostream& operator<<(ostream& out, const Latency& p) {
   return out;
 }
 //--------------------------------------------------------------------------------
+ostream& operator<<(ostream& out, const Latency& p) {
+  FormatBuffer buffer;
+  buffer << p;
+  return out << buffer.view();
+}
+//--------------------------------------------------------------------------------
 string EBS::getDescription() const {
-  stringstream ss;
+  FormatBuffer ss;
   ss << numDevices << "x";
   ss << getTypeName(type);
   ss << "(";
@@ -130,22 +145,27 @@ string EBS::getDescription() const {
 //--------------------------------------------------------------------------------
 bool FailoverTime::machineReadable = false;
 //--------------------------------------------------------------------------------
-ostream& operator<<(ostream& out, const FailoverTime& r) {
-  stringstream ss;
-  ss << r.value;
+FormatBuffer& operator<<(FormatBuffer& out, const FailoverTime& r) {
+  out << r.value;
   if (!FailoverTime::machineReadable) {
-     ss << "s";
+     out << "s";
   }
-  out << ss.str();
   return out;
 }
 //--------------------------------------------------------------------------------
+ostream& operator<<(ostream& out, const FailoverTime& r) {
+  FormatBuffer buffer;
+  buffer << r;
+  return out << buffer.view();
+}
+//--------------------------------------------------------------------------------
 bool Durability::machineReadable = false;
 //--------------------------------------------------------------------------------
-ostream& operator<<(ostream& out, const Durability& r) {
-  stringstream ss;
-  ss << fixed << setprecision(18) << r.numericValue;
-  auto res = ss.str();
+FormatBuffer& operator<<(FormatBuffer& out, const Durability& r) {
+  // A probability, so the fixed notation always fits
+  char digits[32];
+  auto [end, ec] = to_chars(digits, digits + sizeof(digits), r.numericValue, chars_format::fixed, 18);
+  string_view res{digits, end};
   if (r.numericValue == 1.0) {
     //    out << "100%";
     out << "20";
@@ -157,10 +177,9 @@ ostream& operator<<(ostream& out, const Durability& r) {
     if (res.data()[i] == '9') ++nines;
     else break;
   }
-  stringstream result;
-  result << nines;
+  out << nines;
   if (!Durability::machineReadable) {
-    result << "x9's";
+    out << "x9's";
   }
   // for (unsigned i = 2; i < res.size(); ++i) {
   //    char x = res.data()[i];
@@ -176,10 +195,15 @@ ostream& operator<<(ostream& out, const Durability& r) {
   //    }
   // }
   // result << "%";
-  out << result.str();
   return out;
 }
 //--------------------------------------------------------------------------------
+ostream& operator<<(ostream& out, const Durability& r) {
+  FormatBuffer buffer;
+  buffer << r;
+  return out << buffer.view();
+}
+//--------------------------------------------------------------------------------
 Durability EBS::getDurability(Type type) {
    switch (type) {
       case Type::gp3: return Durability(gp3_durability);
@@ -285,7 +309,7 @@ EBS EBS::createVolume(string_view instanceName, Type type, uint64_t capacity, ui
 }
 //--------------------------------------------------------------------------------
 string EBSAllotment::describe() const {
-  stringstream ss;
+  FormatBuffer ss;
   ss << EBS::getTypeName(type);
   ss << "(";
   BinaryUnitInterpreter::print(ss, size);
@@ -308,7 +332,7 @@ string InstanceStorage::storageTypeToString() const {
 }
 //--------------------------------------------------------------------------------
 string InstanceStorage::getDescription() const {
-  stringstream ss;
+  FormatBuffer ss;
   if (devices != 1.0) {
      ss << devices << "x";
   }
@@ -345,36 +369,41 @@ static pair<double, string> forTimeframe(double v) {
    return make_pair(v,suffix);
 }
 //--------------------------------------------------------------------------------
-ostream& operator<<(ostream& out, const Price& p) {
+FormatBuffer& operator<<(FormatBuffer& out, const Price& p) {
    if (Price::machineReadable) {
       out << p.value;
       return out;
    }
-   stringstream ss;
-   ss << fixed << setprecision(1);
-
    if (p.bill == Price::Bill::PerHour) {
       auto [price, unit] = forTimeframe(p.value);
-      ss << price << "$/" << unit;
+      out.appendFixed(price, 1) << "$/" << unit;
    } else {
-      ss << p.value << "$/1000 Req";
+      out.appendFixed(p.value, 1) << "$/1000 Req";
    }
-   out << ss.str();
    return out;
 }
 //--------------------------------------------------------------------------------
-ostream& operator<<(ostream& out, const Rate& r) {
+ostream& operator<<(ostream& out, const Price& p) {
+   FormatBuffer buffer;
+   buffer << p;
+   return out << buffer.view();
+}
+//--------------------------------------------------------------------------------
+FormatBuffer& operator<<(FormatBuffer& out, const Rate& r) {
    if (Price::machineReadable) {
       out << r.rate;
       return out;
    }
-   stringstream ss;
-   ss << fixed << setprecision(1) << r.rate;
-   ss << "/s";
-   out << ss.str();
+   out.appendFixed(r.rate, 1) << "/s";
    return out;
 }
 //--------------------------------------------------------------------------------
+ostream& operator<<(ostream& out, const Rate& r) {
+   FormatBuffer buffer;
+   buffer << r;
+   return out << buffer.view();
+}
+//--------------------------------------------------------------------------------
 Price operator*(double mul, Price p) {
    p.value *= mul;
    return p;
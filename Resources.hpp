@@ -5,6 +5,7 @@
 #include <compare>
 #include <iosfwd>
 #include "Common.hpp"
+#include "infra/Parser.hpp"
 //--------------------------------------------------------------------------------
 struct FailureMode;
 struct Node;
@@ -24,10 +25,14 @@ struct Latency {
    static Latency deduce(Latency target, std::initializer_list<std::pair<double, Latency>> weights);
    // Give the ratio of lower [0.0-1.0] needed to reach target latency
    static double getRatio(Latency target, Latency lower, Latency higher);
+   /// The expected wait before a request is served by one of `servers` parallel servers at the utilization, infinite when saturated.
+   /// Sakasegawa's approximation of M/M/c, which is exact for a single server. Deterministic service times (M/D/c) halve the wait.
+   static Latency queueing(double utilization, double servers, duration<double> serviceTime, bool deterministic);
    Latency operator+(const Latency& other) const { return Latency{min + other.min, avg + other.avg, max + other.max}.fix(); }
    Latency operator-(const Latency& other) const { return Latency{(min > other.min) ? (min - other.min) : 0ns, (avg > other.avg) ? (avg - other.avg) : 0ns, (max > other.max) ? (max - other.max) : 0ns}.fix(); }
 };
 std::ostream& operator<<(std::ostream&, const Latency& p);
+infra::FormatBuffer& operator<<(infra::FormatBuffer&, const Latency& p);
 //--------------------------------------------------------------------------------
 struct Location {
    virtual Latency getLatency() = 0;
@@ -98,6 +103,7 @@ struct Price {
 };
 constexpr Price Price::zero = Price{0, Price::Bill::PerHour};
 std::ostream& operator<<(std::ostream&, const Price& p);
+infra::FormatBuffer& operator<<(infra::FormatBuffer&, const Price& p);
 //--------------------------------------------------------------------------------
 struct Rate {
   // Normalized to secondly
@@ -142,6 +148,7 @@ struct Rate {
 constexpr Rate Rate::zero = Rate(0);
 constexpr Rate Rate::unlimited = Rate(99999999999);
 std::ostream& operator<<(std::ostream&, const Rate& r);
+infra::FormatBuffer& operator<<(infra::FormatBuffer&, const Rate& r);
 //--------------------------------------------------------------------------------
 Price operator*(Price, Rate);
 Price operator*(double mul, Price p);
@@ -200,6 +207,7 @@ struct Durability {
    }
 };
 std::ostream& operator<<(std::ostream&, const Durability& r);
+infra::FormatBuffer& operator<<(infra::FormatBuffer&, const Durability& r);
 //--------------------------------------------------------------------------------
 struct FailoverTime {
    static bool machineReadable;
@@ -212,6 +220,7 @@ struct FailoverTime {
    FailoverTime operator+(FailoverTime other) const { return FailoverTime{value + other.value}; }
 };
 std::ostream& operator<<(std::ostream&, const FailoverTime& f);
+infra::FormatBuffer& operator<<(infra::FormatBuffer&, const FailoverTime& f);
 //--------------------------------------------------------------------------------
 struct CPU {
    static constexpr double defaultSpeedGhz = 2.2;
@@ -545,13 +554,11 @@ struct Parameter {
    double ec2Discount;
    unsigned numberOfAZs = 3;
 
-   std::string logServiceInstance = "i3en.24xl"; // Difference is that we don't need that much capacity
    uint64_t logServiceCapacityInSeconds = 3600;
   //   uint64_t logDeviceCapacityInSeconds = 100;
    uint64_t logServiceReplication = 6;
    uint64_t logRecordHeaderSize = 6 * 8;
 
-   std::string pageServiceInstance = "i3en.24xl";
    unsigned pageServerReplication = 2;
    bool groupCommit = true;
    bool deployAcrossAZ = false;
@@ -562,6 +569,8 @@ struct Parameter {
    /// An update requires to find the page in the index, and then load and update one additional page
    /// The total data size grows in this scenario
    bool indexOnlyTables = true;
+   /// Add the queueing delays at the utilization of the required workload to the latencies, instead of the latencies of idle devices
+   bool queueingLatency = false;
 
    Latency requiredOpLatency;
    Durability requiredDurability;
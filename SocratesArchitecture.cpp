@@ -50,6 +50,17 @@ SocratesLike::SocratesLike(const Parameter& p, const Primary& prim, const Node&
 
    secLookups = vmin(lookups * secondaries.availableForLookups(), parameter.requiredLookupOps - lookups);
 
+   // Utilization at the required rate, the page servers serve the misses of all nodes
+   auto opsPerNode = parameter.requiredOpsPerNode();
+   setUtilization(Resource::CPU, opsPerNode, cpuUpdates);
+   setUtilization(Resource::NetworkIn, opsPerNode * primary.probCacheMiss(), networkPageReads);
+   setUtilization(Resource::NetworkOut, parameter.requiredUpdateOps, networkLogWrites);
+   setUtilization(Resource::InstanceStorageIOPS, opsPerNode * primary.probSecondCacheHit(), storagePageReads);
+   setUtilization(Resource::InstanceStorageIOPS, opsPerNode * primary.probSecondCacheHit(), storagePageWrites);
+   setUtilization(Resource::LogService, parameter.requiredUpdateOps, logService.getNodeUpdateOps());
+   setUtilization(Resource::PageService, parameter.requiredOps() * primary.probCacheMiss(), pageService.getPageReadOps());
+   setEBSUtilization();
+
    primary.networkIn = (updates + lookups).rate * parameter.pageSize * primary.probCacheMiss();
    primary.networkOut = updates.rate * parameter.getRedoLogRecordSize(); // We only stream to one log service
 
@@ -66,20 +77,32 @@ SocratesLike::SocratesLike(const Parameter& p, const Primary& prim, const Node&
 
    opLatency = Latency::combine({{primary.probCacheHit(), primary.getCacheHitLatency()},
                                  {primary.probCacheMiss(),pageService.getOpLatency()}});
+   // The hits in the buffer pool extension queue at the instance storage, the misses at the network and the page servers
+   addQueueingDelays({{primary.probSecondCacheHit(), Resource::InstanceStorageIOPS, InstanceStorage::readLatency},
+                      {primary.probCacheMiss(), Resource::NetworkIn, Latency{0ns}},
+                      {primary.probCacheMiss(), Resource::PageService, pageService.getOpLatency()}},
+                     {{Resource::NetworkOut, Latency{0ns}}, {Resource::LogService, commitLatency}});
+}
+//--------------------------------------------------------------------------------
+Price SocratesLike::getPriceLowerBound(const Parameter& p, const Node& n, const Node& page) {
+   // Primary and secondaries, plus the share of the page servers that is needed to hold the data.
+   // Counting the page server memory as storage gives the smaller fraction, so the bound also holds without rbpex.
+   return (1.0 + p.numSecondaries) * n.price + Ec2PageService::getStorageFraction(p, page, p.pageServerReplication, true) * page.price;
 }
 //--------------------------------------------------------------------------------
-unique_ptr<SocratesLike> SocratesLike::assemble(const Parameter& p2, const Node& n, const Node& page, const Node& log, bool usesBufferPoolExtension) {
+unique_ptr<SocratesLike> SocratesLike::assemble(const Parameter& p2, const PrimaryPrototype& prototype, const Node& page, const Node& log, bool usesBufferPoolExtension) {
+   auto& n = prototype.getNode();
    auto p = p2;
    assert(p.indexOnlyTables);
    p.walIncludesUndo = false;
    auto adjustedOps = p.requiredOpsPerNode();
 
-   if (!n.instanceStorage || n.instanceStorage.getUsableSize() < n.memory.getTotalSize()) return {}; // Socrates uses buffer pool extension
+   if (!n.instanceStorage || n.instanceStorage.getUsableSize() < n.memory.getTotalSize()) return reject(Rejection::InstanceStorage); // Socrates uses buffer pool extension
    // The p4d.24 has super fast networking, but not enough local IOPS, so RBPEX does not make sense
    if (n.name == "p4d.24") {
      usesBufferPoolExtension = false;
    }
-   Primary primary{p, n, usesBufferPoolExtension};
+   Primary primary{prototype.get(usesBufferPoolExtension), p};
    // Storage on page servers can be scaled infinitly, we don't need to check it here
 
    // For logging, we need to check if the EBS device of the log service can sustain the workload. The rest can scale up to one full instance
@@ -94,12 +117,12 @@ unique_ptr<SocratesLike> SocratesLike::assemble(const Parameter& p2, const Node&
    auto storageWrites = adjustedOps * primary.probSecondCacheHit() * iopsPerPage;
    auto storageReads = adjustedOps * primary.probSecondCacheHit() * iopsPerPage;
 
-   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return {};
-   if (networkWrites > primary.n.network.getWriteLimit()) return {};
-   if (networkReads > (primary.n.network.getReadLimit() / p.pageSize).roundDown()) return {};
+   if (adjustedOps > primary.n.cpu.getOps(p.cpuCost)) return reject(Rejection::CPUOps);
+   if (networkWrites > primary.n.network.getWriteLimit()) return reject(Rejection::NetworkWrite);
+   if (networkReads > (primary.n.network.getReadLimit() / p.pageSize).roundDown()) return reject(Rejection::NetworkRead);
    //   cerr << "secondaries: " << secondaries << "; storage writes: " << storageWrites << "; limit: " << primary.n.instanceStorage.getWriteOps() << "\n";
-   if (storageWrites > primary.n.instanceStorage.getWriteOps()) return {};
-   if (storageReads > primary.n.instanceStorage.getReadOps()) return {};
+   if (storageWrites > primary.n.instanceStorage.getWriteOps()) return reject(Rejection::StorageIOPS);
+   if (storageReads > primary.n.instanceStorage.getReadOps()) return reject(Rejection::StorageIOPS);
 
    return make_unique<SocratesLike>(p, primary, page, std::move(logService));
 }
@@ -34,6 +34,8 @@ struct SocratesLike : public Architecture {
    Durability getDurability() const override { return durability; }
    FailoverTime getFailoverTime() const override;
 
-   static std::unique_ptr<SocratesLike> assemble(const Parameter& p, const Node& n, const Node& page, const Node& log, bool useRBPex = true);
+   static std::unique_ptr<SocratesLike> assemble(const Parameter& p, const PrimaryPrototype& prototype, const Node& page, const Node& log, bool useRBPex = true);
+   /// A cheap lower bound on the total price of the architecture built by assemble, with or without rbpex
+   static Price getPriceLowerBound(const Parameter& p, const Node& n, const Node& page);
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+#include "Stats.hpp"
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <ostream>
+//--------------------------------------------------------------------------------
+using namespace std;
+//--------------------------------------------------------------------------------
+static atomic<unsigned> countingStats = 0;
+static atomic<uint64_t> numAllocations = 0;
+static atomic<uint64_t> numAllocatedBytes = 0;
+//--------------------------------------------------------------------------------
+// Replaces the global allocation functions, the array and nothrow versions forward to these
+void* operator new(size_t size) {
+   if (countingStats.load(memory_order_relaxed)) {
+      numAllocations.fetch_add(1, memory_order_relaxed);
+      numAllocatedBytes.fetch_add(size, memory_order_relaxed);
+   }
+   if (auto ptr = malloc(size ? size : 1)) return ptr;
+   throw bad_alloc();
+}
+//--------------------------------------------------------------------------------
+void operator delete(void* ptr) noexcept {
+   free(ptr);
+}
+//--------------------------------------------------------------------------------
+void operator delete(void* ptr, size_t) noexcept {
+   free(ptr);
+}
+//--------------------------------------------------------------------------------
+Stats::Phase::Phase(Stats* stats, string name) : stats{stats} {
+   if (!stats) return;
+   this->name = std::move(name);
+   allocations = numAllocations;
+   allocatedBytes = numAllocatedBytes;
+   start = chrono::steady_clock::now();
+}
+//--------------------------------------------------------------------------------
+Stats::Phase::~Phase() {
+   if (!stats) return;
+   auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   stats->phases.push_back({std::move(name), seconds, numAllocations - allocations, numAllocatedBytes - allocatedBytes});
+}
+//--------------------------------------------------------------------------------
+uint64_t Stats::Funnel::getConsidered() const {
+   return accumulate(rejected.begin(), rejected.end(), pruned + assembled, [](uint64_t sum, auto& r) { return sum + r; });
+}
+//--------------------------------------------------------------------------------
+Stats::Stats() {
+   ++countingStats;
+}
+//--------------------------------------------------------------------------------
+Stats::~Stats() {
+   --countingStats;
+}
+//--------------------------------------------------------------------------------
+void Stats::print(ostream& out) const {
+   out << "{\"instances\": " << instances << ", \"phases\": [";
+   for (unsigned i = 0; i < phases.size(); ++i) {
+      auto& p = phases[i];
+      out << (i ? ", " : "") << "{\"name\": \"" << p.name << "\", \"seconds\": " << p.seconds << ", \"allocations\": " << p.allocations << ", \"allocatedBytes\": " << p.allocatedBytes << "}";
+   }
+   out << "], \"offerSeconds\": " << offerNanoseconds / 1e9;
+   out << ", \"funnel\": {";
+   bool first = true;
+   for (unsigned t = 0; t < funnel.size(); ++t) {
+      auto& f = funnel[t];
+      auto considered = f.getConsidered();
+      if (!considered) continue;
+      out << (first ? "" : ", ") << "\"" << archTypeToName(static_cast<ArchType>(t)) << "\": {\"considered\": " << considered << ", \"pruned\": " << f.pruned << ", \"rejected\": {";
+      first = false;
+      bool firstReason = true;
+      for (unsigned r = 0; r < numRejections; ++r) {
+         if (!f.rejected[r]) continue;
+         out << (firstReason ? "" : ", ") << "\"" << rejectionToName(static_cast<Rejection>(r)) << "\": " << f.rejected[r];
+         firstReason = false;
+      }
+      out << "}, \"assembled\": " << f.assembled << ", \"filtered\": " << f.filtered << ", \"printed\": " << f.printed << "}";
+   }
+   out << "}}\n";
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#pragma once
+#include "Architecture.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+//--------------------------------------------------------------------------------
+/// The phase timings, allocation counts, and the candidate funnel of one run, printed as json by --stats.
+/// While a Stats object exists, every allocation through operator new is counted.
+struct Stats {
+   struct PhaseResult {
+      std::string name;
+      double seconds;
+      uint64_t allocations;
+      uint64_t allocatedBytes;
+   };
+   /// Records the time and the allocations between its construction and destruction as one phase, does nothing without stats
+   class Phase {
+      Stats* stats;
+      std::string name;
+      std::chrono::steady_clock::time_point start;
+      uint64_t allocations;
+      uint64_t allocatedBytes;
+
+      public:
+      Phase(Stats* stats, std::string name);
+      ~Phase();
+      Phase(const Phase&) = delete;
+      Phase& operator=(const Phase&) = delete;
+   };
+   /// What happened to the candidates of one architecture type
+   struct Funnel {
+      /// Skipped because their price lower bound could not beat the retained candidates
+      std::atomic<uint64_t> pruned = 0;
+      std::array<std::atomic<uint64_t>, numRejections> rejected{};
+      std::atomic<uint64_t> assembled = 0;
+      /// Dropped by the registry because they violate a constraint
+      std::atomic<uint64_t> filtered = 0;
+      uint64_t printed = 0;
+
+      uint64_t getConsidered() const;
+   };
+
+   uint64_t instances = 0;
+   std::vector<PhaseResult> phases;
+   std::array<Funnel, 7> funnel;
+   /// The time spent in the registry while filtering and retaining the candidates, summed over all threads
+   std::atomic<uint64_t> offerNanoseconds = 0;
+
+   Stats();
+   ~Stats();
+   Stats(const Stats&) = delete;
+   Stats& operator=(const Stats&) = delete;
+
+   Funnel& operator[](ArchType t) { return funnel[static_cast<uint8_t>(t)]; }
+   void print(std::ostream& out) const;
+};
+//--------------------------------------------------------------------------------
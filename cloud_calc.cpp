@@ -2,23 +2,37 @@
 #include "infra/File.hpp"
 #include "infra/Parser.hpp"
 #include "ArchitectureBuilder.hpp"
+#include "Deployment.hpp"
 #include "Metric.hpp"
 #include "MetricRegistry.hpp"
 #include "Metrics.hpp"
+#include "NodeCatalog.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <exception>
+#include <fstream>
 #include <initializer_list>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <numeric>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 //--------------------------------------------------------------------------------
 using namespace std;
 using namespace infra;
 //--------------------------------------------------------------------------------
 struct CloudCalcArgs : public ArgumentParser {
    OptionalArgument<string> instancesCSV{this, ShortName{"c"}, "instances-csv", "instances csv path", "./instances.csv"};
+   OptionalArgument<bool> nodeSnapshot{this, "node-snapshot", "load the prepared instances from <instances-csv>.nodes, which is rebuilt when the csv changes", true};
    OptionalArgument<uint64_t> datasetSize{this, "datasize", "the size of the data set (in GB)", 100};
    OptionalArgument<double> dataBloat{this, "data-bloat", "the factor how much the data volume is larger in storage", 1.5};
    OptionalArgument<double> usableMemory{this, "usable-memory", "the factor how much memory of the instance can be used for the buffer pool", 0.9};
@@ -36,6 +50,7 @@ struct CloudCalcArgs : public ArgumentParser {
    OptionalArgument<unsigned> pageServerReplication{this, "page-server-replication", "the number of page servers (if used) on which each page is replicated", 2};
    OptionalArgument<bool> groupCommit{this, "group-commit", "let the model use group commit", true};
    OptionalArgument<bool> indexOnlyTables{this, "index-only-tables", "let the model use index-only tables", true};
+   OptionalArgument<bool> queueing{this, "queueing", "add the queueing delays at the utilization of the cores, network, instance storage, EBS, and services to the latencies", false};
    OptionalArgument<bool> deployAcrossAZ{this, "inter-az", "let the model try to distribute instances across AZs", false};
 
    OptionalArgument<string> sortOrder{this, "sort", "the category on which to sort", "TotalPrice"};
@@ -45,13 +60,26 @@ struct CloudCalcArgs : public ArgumentParser {
    OptionalArgument<string> excludedArchitectures{this, "excludes", "exclude these architectures", "dynamic"};
    OptionalArgument<string> csvDelimiter{this, "delimiter", "delimiter for csv mode", ","};
    OptionalArgument<uint64_t> trunc{this, "trunc", "truncate the results, but keep at least this much from each arch", 10};
+   OptionalArgument<string> pareto{this, "pareto", "only print the architectures that are not dominated in these columns instead of truncating, prefix with '-' when larger is better, e.g., 'TotalPrice,OpLatency,-Durability,FailoverTime'", ""};
+   OptionalArgument<string> dedup{this, "dedup", "collapse the architectures that print the same values in these columns into one row, e.g., 'Type,Primary,StorageDesc,TotalPrice'", ""};
    OptionalArgument<bool> filter{this, "filter", "filter the results", true};
+   OptionalArgument<bool> pruneDominated{this, "prune-dominated", "only consider primaries that are not dominated by a cheaper instance with at least the same resources", false};
+   OptionalArgument<bool> prune{this, "prune", "skip candidates whose price lower bound cannot beat the kept results", true};
    OptionalArgument<bool> csvFormat{this, "csv", "print in csv format", false};
+   OptionalArgument<string> columnar{this, "columnar", "write the results to this file as one typed binary array per column instead of printing them, see the README for the layout", ""};
    OptionalArgument<bool> showHidden{this, "show-hidden", "print metrics that are by default hidden", false};
    OptionalArgument<bool> hideCosts{this, "hide-costs", "hide the costs", false};
    OptionalArgument<bool> hideLookups{this, "hide-lookups", "hide the lookups", false};
    OptionalArgument<bool> hideUpdates{this, "hide-updates", "hide the updates", false};
    OptionalArgument<bool> terse{this, "terse", "hide the unimportant metrics", false};
+   OptionalArgument<double> headroom{this, "headroom", "print the max transactions every architecture sustains at the update ratio and its headroom over --transactions, and filter out the ones with less headroom than this, e.g., 2 to size for twice the peak (0 = off)", 0.0};
+   OptionalArgument<bool> stats{this, "stats", "print the time and allocations of every phase and the funnel of the candidates per architecture as json on stderr", false};
+   OptionalArgument<unsigned> threads{this, "threads", "the number of threads used to enumerate and rank architectures, or to evaluate the grid points of a sweep", 1};
+   OptionalArgument<bool> serve{this, "serve", "keep the instances loaded and answer one json request per line from stdin, e.g., {\"transactions\": 10000, \"update-ratio\": 0.5}, with the csv rows and a blank line", false};
+   OptionalArgument<string> serveSocket{this, "serve-socket", "like --serve, but answer the requests on this unix socket", ""};
+   OptionalArgument<string> deploy{this, "deploy", "only evaluate this deployment and print all its metrics, e.g., 'type=socrates;primary=c6gd.l;secondaries=1;page=i3en.24;log=i4i.32;rbpex=true'. Supports type, primary, secondaries, page (socrates and aurora), log and rbpex (socrates), and ebs (rbd)", ""};
+   OptionalArgument<string> envelope{this, "envelope", "print the capacity envelope of the --deploy deployment over a grid of workloads as csv, with the binding resource and the max transactions at every point, e.g., 'update-ratio=0,0.3,0.7;lookup-zipf=0,1;transactions=1000,10000'", ""};
+   OptionalArgument<string> sweep{this, "sweep", "evaluate a grid of workloads in one run and print a combined csv, e.g., 'transactions=1000,10000;update-ratio=0,0.3'. Supports datasize, transactions, update-ratio, lookup-zipf, latency, durability, and inter-az", ""};
 
    OptionalArgument<double> ec2Discount{this, "ec2-discount", "The discount on EC2 (but not EBS,S3 etc.) we assume due to reserved instance savings etc.", 0.5};
 
@@ -59,109 +87,128 @@ struct CloudCalcArgs : public ArgumentParser {
    OptionalArgument<double> interAZLatency{this, "inter-az-latency", "The assumed latency between two ec2 machines in different AZs in the same region", 1.0};
 };
 //--------------------------------------------------------------------------------
-int main(int argc, char** argv) {
-   CloudCalcArgs args;
-   if (!args.parse(argc, argv)) {
-      cerr << args.getHelp() << "\n";
-      exit(1);
-   }
-
-   BinaryUnitInterpreter::machineReadable = args.csvFormat.get();
-   DecimalUnitInterpreter::machineReadable = args.csvFormat.get();
-   Latency::machineReadable = args.csvFormat.get();
-   Price::machineReadable = args.csvFormat.get();
-   Durability::machineReadable = args.csvFormat.get();
-   FailoverTime::machineReadable = args.csvFormat.get();
-
-   if (args.priceUnit.get() == "hour") {
-      Price::timeunitForPrint = Timeunit::Hour;
-   } else if (args.priceUnit.get() == "day") {
-      Price::timeunitForPrint = Timeunit::Day;
-   } else if (args.priceUnit.get() == "month") {
-      Price::timeunitForPrint = Timeunit::Month;
-   } else if (args.priceUnit.get() == "year") {
-      Price::timeunitForPrint = Timeunit::Year;
-   } else {
-      cerr << "Invalid price unit: " << args.priceUnit.get() << "\n";
-      exit(1);
-   }
-
-
-   VantageCSV vantageCSV;
-   try {
-      infra::File data{args.instancesCSV.get(), File::AccessMode::ReadOnly};
-      data.open(OpenMode::Open);
-      auto input = data.readWholeFile();
-      CSVReader reader{input};
-      vantageCSV.parse(reader);
-
-   } catch (const exception& e) {
-      cerr << e.what();
-      exit(1);
+/// The workload parameters that runAllCalcs in plots.R iterates over
+struct Workload {
+   uint64_t datasetSize;
+   uint64_t transactions;
+   double updateRatio;
+   double lookupZipf;
+   uint64_t requiredOpLatency;
+   uint32_t requiredDurability;
+   bool deployAcrossAZ;
+};
+//--------------------------------------------------------------------------------
+static Workload getWorkload(const CloudCalcArgs& args) {
+   return Workload{
+      .datasetSize = args.datasetSize.get(),
+      .transactions = args.transactions.get(),
+      .updateRatio = args.updateRatio.get(),
+      .lookupZipf = args.lookupZipf.get(),
+      .requiredOpLatency = args.requiredOpLatency.get(),
+      .requiredDurability = args.requiredDurability.get(),
+      .deployAcrossAZ = args.deployAcrossAZ.get(),
+   };
+}
+//--------------------------------------------------------------------------------
+/// Sets one workload parameter by its command line name, used by the sweep specs and the serve requests
+static void setWorkloadValue(Workload& w, const string& key, const string& value) {
+   auto parse = [&](auto& field) {
+      stringstream ss{value};
+      ss >> field;
+      if (ss.fail() || !ss.eof()) throw runtime_error("invalid value '" + value + "' for '" + key + "'");
+   };
+   if (key == "datasize") parse(w.datasetSize);
+   else if (key == "transactions") parse(w.transactions);
+   else if (key == "update-ratio") parse(w.updateRatio);
+   else if (key == "lookup-zipf") parse(w.lookupZipf);
+   else if (key == "latency") parse(w.requiredOpLatency);
+   else if (key == "durability") parse(w.requiredDurability);
+   else if (key == "inter-az") {
+      if (value == "true" || value == "false") w.deployAcrossAZ = (value == "true");
+      else parse(w.deployAcrossAZ);
+   } else throw runtime_error("unknown workload parameter '" + key + "'");
+}
+//--------------------------------------------------------------------------------
+/// Expands a spec like 'transactions=1000,10000;update-ratio=0,0.3' into the cross product, the other parameters are taken from the defaults
+static vector<Workload> parseSweep(string_view spec, const Workload& defaults) {
+   vector<Workload> grid{defaults};
+   for (auto& dimension : Parser::split(spec, ';')) {
+      if (dimension.empty()) continue;
+      auto assignment = Parser::split(dimension, '=');
+      if (assignment.size() != 2) throw runtime_error("invalid sweep dimension '" + dimension + "'");
+      auto& key = assignment[0];
+      auto values = Parser::split(assignment[1], ',');
+      vector<Workload> expanded;
+      for (auto& w : grid) {
+         for (auto& v : values) {
+            expanded.push_back(w);
+            setWorkloadValue(expanded.back(), key, v);
+         }
+      }
+      grid = std::move(expanded);
    }
-   auto datasetSizeInBytes = 1024ull * 1024 * 1024 * args.datasetSize;
+   return grid;
+}
+//--------------------------------------------------------------------------------
+static optional<Parameter> makeParameter(const CloudCalcArgs& args, const Workload& w) {
+   auto datasetSizeInBytes = 1024ull * 1024 * 1024 * w.datasetSize;
 
-   if (args.lookupZipf != 0.0 && args.updateRatio > 0) {
+   if (w.lookupZipf != 0.0 && w.updateRatio > 0) {
      cerr << "Error! Cannot specify a lookup zipf when there are also updates\n";
-     return 1;
+     return nullopt;
    }
-   auto updates = args.transactions * args.updateRatio;
-   auto lookups = args.transactions - updates;
-   Parameter p{
+   auto updates = w.transactions * w.updateRatio;
+   auto lookups = w.transactions - updates;
+   return Parameter{
       .datasetSize = datasetSizeInBytes,
-      .dataBloat = args.dataBloat,
-      .usableMemory = args.usableMemory,
-      .networkOverhead = args.networkOverhead,
+      .dataBloat = args.dataBloat.get(),
+      .usableMemory = args.usableMemory.get(),
+      .networkOverhead = args.networkOverhead.get(),
       .requiredLookupOps = Rate::secondly(lookups),
-      .lookupZipf = args.lookupZipf,
+      .lookupZipf = w.lookupZipf,
       .requiredUpdateOps = Rate::secondly(updates),
-      .tupleSize = args.tupleSize,
-      .pageSize = args.pageSize,
-      .cpuCost = args.cpuCost,
+      .tupleSize = args.tupleSize.get(),
+      .pageSize = args.pageSize.get(),
+      .cpuCost = args.cpuCost.get(),
       .minSecondaries = static_cast<unsigned>(args.minReplicas.get()),
       .maxSecondaries = static_cast<unsigned>(args.maxReplicas.get()),
-      .intraAZLatency = args.intraAZLatency,
-      .interAZLatency = args.interAZLatency,
-      .ec2Discount = args.ec2Discount,
-      .pageServerReplication = args.pageServerReplication,
-      .groupCommit = args.groupCommit,
-      .deployAcrossAZ = args.deployAcrossAZ,
-      .indexOnlyTables = args.indexOnlyTables,
-      .requiredOpLatency = Latency{nanoseconds(args.requiredOpLatency.get())},
-      .requiredDurability = Durability{args.requiredDurability, nines},
+      .intraAZLatency = args.intraAZLatency.get(),
+      .interAZLatency = args.interAZLatency.get(),
+      .ec2Discount = args.ec2Discount.get(),
+      .pageServerReplication = args.pageServerReplication.get(),
+      .groupCommit = args.groupCommit.get(),
+      .deployAcrossAZ = w.deployAcrossAZ,
+      .indexOnlyTables = args.indexOnlyTables.get(),
+      .queueingLatency = args.queueing.get(),
+      .requiredOpLatency = Latency{nanoseconds(w.requiredOpLatency)},
+      .requiredDurability = Durability{w.requiredDurability, nines},
    };
-
-   if(p.minSecondaries > p.maxSecondaries) {
-     cerr << "min secondaries must be smaller than max secondaries";
-     exit(1);
-   }
-
-   auto archs = infra::Parser::split(args.architectures.get(), ',');
-   auto excludes = infra::Parser::split(args.excludedArchitectures.get(), ',');
-   if (archs.size() == 1 && archs[0] == "") archs.clear();
-   ArchitectureBuilder builder{vantageCSV, p, args.instanceFilter.get(), archs, excludes};
-
-   MetricRegistry registry{args.csvFormat, args.showHidden,args.csvDelimiter};
+}
+//--------------------------------------------------------------------------------
+static void setupRegistry(MetricRegistry& registry, const CloudCalcArgs& args, const Parameter& p) {
    registry.add<IdMetric>();
    registry.add<TypeMetric>();
    registry.add<PrimaryMetric>();
-   if (!args.terse) registry.add<CPUVendorMetric>();
+   if (!args.terse.get()) registry.add<CPUVendorMetric>();
    registry.add<StorageMetric>();
-   if (!args.terse) registry.add<StorageDevice>();
+   if (!args.terse.get()) registry.add<StorageDevice>();
    registry.add<LogServiceMetric>();
    registry.add<SecondaryMetric>();
    registry.add<DurabilityMetric>(p.requiredDurability);
    registry.add<OpLatencyMetric>(p.requiredOpLatency);
-   if (!args.terse) registry.add<CommitLatencyMetric>();
+   if (!args.terse.get()) registry.add<CommitLatencyMetric>();
+   registry.hideNextMetrics(true);
+   registry.add<FailoverTimeMetric>();
+   registry.hideNextMetrics(false);
    registry.add<TotalPrice>();
    registry.add<PrimaryPrice>();
    registry.add<EBSPrice>();
    registry.add<SecondariesPrice>();
    registry.add<LogServicePrice>();
    registry.add<PageServicePrice>();
-   if (!args.terse) registry.add<S3Price>();
+   if (!args.terse.get()) registry.add<S3Price>();
    registry.add<NetworkPrice>();
-   if (!args.terse) registry.add<DatasetSize>(p.getDataSize());
+   if (!args.terse.get()) registry.add<DatasetSize>(p.getDataSize());
    registry.add<PrimaryBufferCache>();
    registry.add<PrimaryBufferCacheHitrate>();
    registry.add<StorageCapacity>();
@@ -169,23 +216,486 @@ int main(int argc, char** argv) {
    registry.add<SecondariesRandomLookupTx>();
    registry.add<RandomLookupTx>(p.requiredLookupOps);
    registry.add<RandomUpdateTx>(p.requiredUpdateOps);
-   if (!args.terse) registry.add<PageReadVolume>();
-   if (!args.terse) registry.add<PageWriteVolume>();
+   if (!args.terse.get()) registry.add<PageReadVolume>();
+   if (!args.terse.get()) registry.add<PageWriteVolume>();
    registry.add<NetworkInVolume>();
    registry.add<NetworkOutVolume>();
    registry.add<LogVolume>();
-   if (!args.terse) registry.add<InterAZTraffic>();
-
-   registry.printHeader(args.csvFormat ? cout : cerr);
-   for (auto& a : builder.getArchitectures()) {
-     registry.insert(*a);
+   if (!args.terse.get()) registry.add<InterAZTraffic>();
+   registry.add<BottleneckMetric>();
+   // A pinned deployment is checked for how much more load it takes
+   if (args.headroom.get() > 0.0 || !args.deploy.get().empty()) {
+      registry.add<MaxTransactionsMetric>();
+      registry.add<HeadroomMetric>(args.headroom.get());
    }
-   if (args.filter.get()) {
-     registry.filter();
+   registry.hideNextMetrics(true);
+   for (unsigned r = 0; r < numResources; ++r) {
+      registry.add<UtilizationMetric>(static_cast<Resource>(r));
    }
+   registry.hideNextMetrics(false);
+}
+//--------------------------------------------------------------------------------
+static void configureRegistry(MetricRegistry& registry, const CloudCalcArgs& args) {
+   registry.setFilter(args.filter.get());
+   registry.setPruning(args.prune.get());
+   registry.setDedup(args.dedup.get());
+   registry.setPareto(args.pareto.get());
    if (!args.sortOrder.get().empty()) {
-     registry.sortAndTrunc(args.sortOrder.get(), args.trunc.get());
+     registry.setSortOrder(args.sortOrder.get(), args.trunc.get());
+   }
+}
+//--------------------------------------------------------------------------------
+/// The columns runAllCalcs used to append in R, so the combined csv can be used as before
+static void addWorkloadColumns(MetricRegistry& registry, const Workload& w) {
+   auto str = [](auto v) {
+      stringstream ss;
+      ss << v;
+      return ss.str();
+   };
+   registry.add<ParameterValue>("ops", str(w.transactions));
+   registry.add<ParameterValue>("lookupZipf", str(w.lookupZipf));
+   registry.add<ParameterValue>("percentUpdates", str(w.updateRatio * 100));
+   registry.add<ParameterValue>("requiredLatency", str(w.requiredOpLatency));
+   registry.add<ParameterValue>("requiredDurability", str(w.requiredDurability));
+   registry.add<ParameterValue>("interAZ", w.deployAcrossAZ ? "TRUE" : "FALSE");
+}
+//--------------------------------------------------------------------------------
+/// Builds the deployment for the workload w at the given number of transactions
+static unique_ptr<Architecture> assembleAt(const CloudCalcArgs& args, const Deployment& d, Workload w, uint64_t transactions) {
+   w.transactions = transactions;
+   auto p = makeParameter(args, w);
+   if (!p) return nullptr;
+   return d.assemble(*p);
+}
+//--------------------------------------------------------------------------------
+/// The largest number of transactions at the update ratio of w for which the deployment can be built, nullopt if it cannot even hold the data set
+static optional<uint64_t> findMaxTransactions(const CloudCalcArgs& args, const Deployment& d, const Workload& w) {
+   auto fits = [&](uint64_t transactions) { return assembleAt(args, d, w, transactions) != nullptr; };
+   // The load only grows with the transactions, so bisect between a feasible and an infeasible count
+   uint64_t low = 1;
+   if (!fits(low)) return nullopt;
+   // Grow the bound until the deployment breaks, every design runs out of cpu eventually
+   constexpr uint64_t limit = 1ull << 40;
+   uint64_t high = std::max<uint64_t>(w.transactions, 2);
+   while (fits(high)) {
+      low = high;
+      if (high >= limit) return high;
+      high *= 2;
+   }
+   while (high - low > 1) {
+      auto mid = low + (high - low) / 2;
+      if (fits(mid)) {
+         low = mid;
+      } else {
+         high = mid;
+      }
+   }
+   return low;
+}
+//--------------------------------------------------------------------------------
+/// Where one workload of the capacity envelope sits relative to the frontier of the deployment
+struct EnvelopePoint {
+   bool feasible = false;
+   uint64_t maxTransactions = 0;
+   /// The most utilized resource at the frontier, or the rejection when the deployment cannot hold the data set
+   string binding;
+   /// The check of the model that fails right beyond the frontier
+   string rejection;
+};
+//--------------------------------------------------------------------------------
+static EnvelopePoint evaluateEnvelopePoint(const CloudCalcArgs& args, const Deployment& d, const Workload& w) {
+   EnvelopePoint point;
+   point.feasible = assembleAt(args, d, w, w.transactions) != nullptr;
+   auto maxTransactions = findMaxTransactions(args, d, w);
+   if (!maxTransactions) {
+      point.binding = point.rejection = rejectionToName(lastRejection);
+      return point;
+   }
+   point.maxTransactions = *maxTransactions;
+   point.binding = resourceToName(assembleAt(args, d, w, *maxTransactions)->getBottleneck());
+   if (!assembleAt(args, d, w, *maxTransactions + 1)) point.rejection = rejectionToName(lastRejection);
+   return point;
+}
+//--------------------------------------------------------------------------------
+/// Prints the frontier of the deployment for every workload of the grid as csv, one row per grid point
+static void printEnvelope(const CloudCalcArgs& args, const Deployment& d, const vector<Workload>& grid) {
+   vector<optional<EnvelopePoint>> points(grid.size());
+   infra::WorkStealingPool pool{args.threads.get()};
+   pool.run(grid.size(), [&](uint64_t i) {
+      // Reports the invalid workloads, like a lookup zipf with updates, once per grid point
+      if (makeParameter(args, grid[i])) points[i] = evaluateEnvelopePoint(args, d, grid[i]);
+   });
+   auto del = args.csvDelimiter.get();
+   cout << "ops" << del << "percentUpdates" << del << "lookupZipf" << del << "Feasible" << del << "Binding" << del << "Rejection" << del << "MaxTx" << del << "Headroom\n";
+   for (uint64_t i = 0; i < grid.size(); ++i) {
+      if (!points[i]) continue;
+      auto& w = grid[i];
+      auto& point = *points[i];
+      cout << w.transactions << del << w.updateRatio * 100 << del << w.lookupZipf << del << (point.feasible ? "TRUE" : "FALSE") << del << point.binding << del << point.rejection << del << point.maxTransactions << del << static_cast<double>(point.maxTransactions) / w.transactions << "\n";
+   }
+}
+//--------------------------------------------------------------------------------
+/// The state that stays warm across the requests of serve mode, and that every grid point of a sweep shares
+struct Session {
+   const CloudCalcArgs& args;
+   const vector<Node>& nodes;
+   vector<string> archs;
+   vector<string> excludes;
+};
+//--------------------------------------------------------------------------------
+struct Evaluation {
+   string header;
+   string rows;
+};
+//--------------------------------------------------------------------------------
+/// Builds and ranks all architectures for one workload against the shared nodes
+static optional<Evaluation> evaluate(const Session& s, const Workload& w, bool workloadColumns, unsigned threads) {
+   auto p = makeParameter(s.args, w);
+   if (!p) return nullopt;
+   MetricRegistry registry{true, s.args.showHidden.get(), s.args.csvDelimiter.get()};
+   setupRegistry(registry, s.args, *p);
+   if (workloadColumns) addWorkloadColumns(registry, w);
+   configureRegistry(registry, s.args);
+   ArchitectureBuilder builder{s.nodes, *p, s.args.instanceFilter.get(), s.archs, s.excludes, registry, threads, s.args.pruneDominated.get()};
+   registry.sortAndTrunc(threads);
+   stringstream header;
+   registry.printHeader(header);
+   stringstream rows;
+   registry.print(rows);
+   return Evaluation{header.str(), rows.str()};
+}
+//--------------------------------------------------------------------------------
+/// Parses a flat json object like {"transactions": 10000, "inter-az": true} into its key value pairs
+static vector<pair<string, string>> parseRequest(string_view line) {
+   vector<pair<string, string>> result;
+   size_t pos = 0;
+   auto skipWs = [&]() {
+      while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) ++pos;
+   };
+   auto expect = [&](char c) {
+      skipWs();
+      if (pos >= line.size() || line[pos] != c) throw runtime_error(string("expected '") + c + "' at position " + to_string(pos));
+      ++pos;
+   };
+   auto token = [&]() {
+      skipWs();
+      if (pos < line.size() && line[pos] == '"') {
+         auto end = line.find('"', pos + 1);
+         if (end == string_view::npos) throw runtime_error("unterminated string");
+         string value{line.substr(pos + 1, end - pos - 1)};
+         pos = end + 1;
+         return value;
+      }
+      auto begin = pos;
+      while (pos < line.size() && line[pos] != ',' && line[pos] != '}' && line[pos] != ' ' && line[pos] != '\t') ++pos;
+      if (begin == pos) throw runtime_error("expected a value at position " + to_string(pos));
+      return string{line.substr(begin, pos - begin)};
+   };
+   expect('{');
+   skipWs();
+   if (pos < line.size() && line[pos] == '}') {
+      ++pos;
+   } else {
+      while (true) {
+         auto key = token();
+         expect(':');
+         auto value = token();
+         result.emplace_back(std::move(key), std::move(value));
+         skipWs();
+         if (pos < line.size() && line[pos] == ',') {
+            ++pos;
+            continue;
+         }
+         expect('}');
+         break;
+      }
+   }
+   skipWs();
+   if (pos != line.size()) throw runtime_error("trailing characters after the request");
+   return result;
+}
+//--------------------------------------------------------------------------------
+/// Answers one request line with the csv header and rows, or with an error line. A blank line terminates every answer.
+static string answer(const Session& s, string_view line) {
+   try {
+      auto w = getWorkload(s.args);
+      for (auto& [key, value] : parseRequest(line)) {
+         setWorkloadValue(w, key, value);
+      }
+      auto result = evaluate(s, w, false, s.args.threads.get());
+      if (!result) return "error: invalid workload\n\n";
+      return result->header + result->rows + "\n";
+   } catch (const exception& e) {
+      return string("error: ") + e.what() + "\n\n";
+   }
+}
+//--------------------------------------------------------------------------------
+static void serveStdin(const Session& s) {
+   string line;
+   while (getline(cin, line)) {
+      if (line.empty()) continue;
+      cout << answer(s, line) << flush;
+   }
+}
+//--------------------------------------------------------------------------------
+static bool writeAll(int fd, string_view data) {
+   while (!data.empty()) {
+      auto written = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+      if (written < 0) {
+         if (errno == EINTR) continue;
+         return false;
+      }
+      data.remove_prefix(written);
+   }
+   return true;
+}
+//--------------------------------------------------------------------------------
+/// Accepts the clients one after the other, each of them may send any number of requests
+static int serveSocket(const Session& s, const string& path) {
+   sockaddr_un addr{};
+   if (path.size() >= sizeof(addr.sun_path)) {
+      cerr << "socket path too long: " << path << "\n";
+      return 1;
+   }
+   addr.sun_family = AF_UNIX;
+   strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+   int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listenFd < 0) {
+      cerr << "socket: " << strerror(errno) << "\n";
+      return 1;
+   }
+   ::unlink(path.c_str());
+   if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd, 16) < 0) {
+      cerr << "cannot listen on " << path << ": " << strerror(errno) << "\n";
+      ::close(listenFd);
+      return 1;
+   }
+   cerr << "Listening on " << path << "\n";
+   while (true) {
+      int fd = ::accept(listenFd, nullptr, nullptr);
+      if (fd < 0) {
+         if (errno == EINTR) continue;
+         cerr << "accept: " << strerror(errno) << "\n";
+         break;
+      }
+      string buffer;
+      char chunk[4096];
+      bool open = true;
+      while (open) {
+         auto bytes = ::read(fd, chunk, sizeof(chunk));
+         if (bytes < 0 && errno == EINTR) continue;
+         if (bytes <= 0) break;
+         buffer.append(chunk, bytes);
+         size_t begin = 0;
+         for (auto end = buffer.find('\n'); end != string::npos; end = buffer.find('\n', begin)) {
+            string_view line{buffer.data() + begin, end - begin};
+            begin = end + 1;
+            if (line.empty()) continue;
+            if (!writeAll(fd, answer(s, line))) {
+               open = false;
+               break;
+            }
+         }
+         buffer.erase(0, begin);
+      }
+      ::close(fd);
+   }
+   ::close(listenFd);
+   ::unlink(path.c_str());
+   return 1;
+}
+//--------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+   CloudCalcArgs args;
+   if (!args.parse(argc, argv)) {
+      cerr << args.getHelp() << "\n";
+      exit(1);
+   }
+
+   // A sweep and the serve mode always print csv
+   bool sweep = !args.sweep.get().empty();
+   bool serve = args.serve.get() || !args.serveSocket.get().empty();
+   bool csvFormat = args.csvFormat.get() || sweep || serve;
+   bool columnar = !args.columnar.get().empty();
+   bool deploy = !args.deploy.get().empty();
+   bool envelope = !args.envelope.get().empty();
+   if (deploy && (sweep || serve)) {
+      cerr << "--deploy cannot be combined with --sweep or --serve\n";
+      exit(1);
+   }
+   if (envelope && (!deploy || columnar)) {
+      cerr << "--envelope needs --deploy and cannot be combined with --columnar\n";
+      exit(1);
+   }
+   if (columnar && (sweep || serve)) {
+      cerr << "--columnar cannot be combined with --sweep or --serve\n";
+      exit(1);
+   }
+   if (args.stats.get() && (sweep || serve)) {
+      cerr << "--stats cannot be combined with --sweep or --serve\n";
+      exit(1);
+   }
+   optional<Stats> stats;
+   if (args.stats.get()) stats.emplace();
+   Stats* statsPtr = stats ? &*stats : nullptr;
+   // The text columns of the columnar output use the same raw values as the csv
+   bool machineReadable = csvFormat || columnar;
+   BinaryUnitInterpreter::machineReadable = machineReadable;
+   DecimalUnitInterpreter::machineReadable = machineReadable;
+   Latency::machineReadable = machineReadable;
+   Price::machineReadable = machineReadable;
+   Durability::machineReadable = machineReadable;
+   FailoverTime::machineReadable = machineReadable;
+
+   if (args.priceUnit.get() == "hour") {
+      Price::timeunitForPrint = Timeunit::Hour;
+   } else if (args.priceUnit.get() == "day") {
+      Price::timeunitForPrint = Timeunit::Day;
+   } else if (args.priceUnit.get() == "month") {
+      Price::timeunitForPrint = Timeunit::Month;
+   } else if (args.priceUnit.get() == "year") {
+      Price::timeunitForPrint = Timeunit::Year;
+   } else {
+      cerr << "Invalid price unit: " << args.priceUnit.get() << "\n";
+      exit(1);
+   }
+
+
+   if (args.minReplicas.get() > args.maxReplicas.get()) {
+     cerr << "min secondaries must be smaller than max secondaries";
+     exit(1);
+   }
+
+   // The nodes do not depend on the workload, so all grid points of a sweep and all requests of the serve mode share them
+   vector<Node> nodes;
+   try {
+      nodes = NodeCatalog::load(args.instancesCSV.get(), args.ec2Discount.get(), args.nodeSnapshot.get(), statsPtr);
+   } catch (const exception& e) {
+      cerr << e.what();
+      exit(1);
+   }
+   Session session{args, nodes, infra::Parser::split(args.architectures.get(), ','), infra::Parser::split(args.excludedArchitectures.get(), ',')};
+   if (session.archs.size() == 1 && session.archs[0] == "") session.archs.clear();
+
+   if (serve) {
+      if (!args.serveSocket.get().empty()) return serveSocket(session, args.serveSocket.get());
+      serveStdin(session);
+      return 0;
+   }
+
+   if (envelope) {
+      try {
+         auto deployment = Deployment::parse(args.deploy.get(), nodes);
+         for (auto& dimension : Parser::split(args.envelope.get(), ';')) {
+            auto key = Parser::split(dimension, '=')[0];
+            if (!dimension.empty() && key != "transactions" && key != "update-ratio" && key != "lookup-zipf") throw runtime_error("the envelope only spans transactions, update-ratio, and lookup-zipf, not '" + key + "'");
+         }
+         auto grid = parseSweep(args.envelope.get(), getWorkload(args));
+         cerr << "Envelope grid points: " << grid.size() << "\n";
+         printEnvelope(args, deployment, grid);
+      } catch (const exception& e) {
+         cerr << e.what() << "\n";
+         return 1;
+      }
+      return 0;
+   }
+
+   if (!sweep) {
+      auto w = getWorkload(args);
+      optional<Deployment> deployment;
+      unique_ptr<Architecture> pinned;
+      if (deploy) {
+         try {
+            deployment = Deployment::parse(args.deploy.get(), nodes);
+         } catch (const exception& e) {
+            cerr << e.what() << "\n";
+            return 1;
+         }
+         auto p = makeParameter(args, w);
+         if (!p) return 1;
+         pinned = deployment->assemble(*p);
+         if (!pinned) {
+            // Show the deployment at the load it still takes, instead of only the reason why it breaks
+            cerr << "The deployment cannot sustain " << w.transactions << " transactions: " << rejectionToName(lastRejection) << "\n";
+            auto maxTransactions = findMaxTransactions(args, *deployment, w);
+            if (!maxTransactions) {
+               cerr << "The deployment cannot hold the data set\n";
+               return 1;
+            }
+            cerr << "Evaluating at the largest sustainable load: " << *maxTransactions << " transactions\n";
+            w.transactions = *maxTransactions;
+         }
+      }
+      auto p = makeParameter(args, w);
+      if (!p) return 1;
+      // A pinned deployment prints all of its metrics, including the utilization of every resource
+      MetricRegistry registry{csvFormat, args.showHidden.get() || deploy, args.csvDelimiter.get()};
+      setupRegistry(registry, args, *p);
+      configureRegistry(registry, args);
+      registry.setStats(statsPtr);
+      optional<ArchitectureBuilder> builder;
+      if (deployment) {
+         // Constraint violations are reported in the columns, the deployment exists either way
+         registry.setFilter(false);
+         if (!pinned) pinned = deployment->assemble(*p);
+         if (!pinned) {
+            cerr << "The deployment cannot be built: " << rejectionToName(lastRejection) << "\n";
+            return 1;
+         }
+         vector<unique_ptr<Architecture>> batch;
+         batch.push_back(std::move(pinned));
+         registry.offer(batch, 0);
+      } else {
+         // The builder streams every candidate into the registry, which only retains the best ones
+         builder.emplace(nodes, *p, args.instanceFilter.get(), session.archs, session.excludes, registry, args.threads.get(), args.pruneDominated.get(), statsPtr);
+      }
+
+      if (columnar) {
+         {
+            Stats::Phase phase{statsPtr, "sort"};
+            registry.sortAndTrunc(args.threads.get());
+         }
+         Stats::Phase phase{statsPtr, "print"};
+         ofstream out{args.columnar.get(), ios::binary};
+         registry.printColumnar(out);
+         out.close();
+         if (!out) {
+            cerr << "cannot write " << args.columnar.get() << "\n";
+            return 1;
+         }
+         cerr << "wrote " << registry.overallSort.size() << " rows to " << args.columnar.get() << "\n";
+      } else {
+         registry.printHeader(csvFormat ? cout : cerr);
+         {
+            Stats::Phase phase{statsPtr, "sort"};
+            registry.sortAndTrunc(args.threads.get());
+         }
+         Stats::Phase phase{statsPtr, "print"};
+         registry.print(cout);
+         cout.flush();
+      }
+      if (stats) stats->print(cerr);
+      return 0;
+   }
+
+   vector<Workload> grid;
+   try {
+      grid = parseSweep(args.sweep.get(), getWorkload(args));
+   } catch (const exception& e) {
+      cerr << e.what() << "\n";
+      return 1;
+   }
+   cerr << "Sweep grid points: " << grid.size() << "\n";
+   // Every grid point gets its own registry and builder, the outputs are concatenated in grid order
+   vector<optional<Evaluation>> results(grid.size());
+   infra::WorkStealingPool pool{args.threads.get()};
+   pool.run(grid.size(), [&](uint64_t i) {
+      results[i] = evaluate(session, grid[i], true, 1);
+   });
+   auto header = std::find_if(results.begin(), results.end(), [](const optional<Evaluation>& r) { return r && !r->header.empty(); });
+   if (header != results.end()) cout << (*header)->header;
+   for (auto& r : results) {
+      if (r) cout << r->rows;
    }
-   registry.print(cout);
 }
 //--------------------------------------------------------------------------------
@@ -1,20 +1,96 @@
 #include "CSV.hpp"
+#include "Parser.hpp"
 #include <algorithm>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 //--------------------------------------------------------------------------------
 using namespace std;
 //--------------------------------------------------------------------------------
 namespace infra {
 //--------------------------------------------------------------------------------
-CSVValueBase::CSVValueBase(CSVSchema* schema, string_view name) : name{name} {
-   schema->base->registerField(this, name);
+uint64_t CSVReader::countLines() const {
+   uint64_t lines = 0;
+   for (auto p = ptr; (p = static_cast<const char*>(memchr(p, '\n', limit - p))); ++p) {
+      ++lines;
+   }
+   return lines + 1;
+}
+//--------------------------------------------------------------------------------
+const char* CSVReader::findSpecial(const char* begin, const char* end) {
+#if defined(__SSE2__)
+   auto comma = _mm_set1_epi8(',');
+   auto quote = _mm_set1_epi8('"');
+   auto newline = _mm_set1_epi8('\n');
+   for (; end - begin >= 16; begin += 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+      auto matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)), _mm_cmpeq_epi8(chunk, newline));
+      if (auto mask = _mm_movemask_epi8(matches)) {
+         return begin + __builtin_ctz(mask);
+      }
+   }
+#endif
+   for (; begin != end; ++begin) {
+      if (*begin == ',' || *begin == '"' || *begin == '\n') break;
+   }
+   return begin;
 }
 //--------------------------------------------------------------------------------
-void CSVNumber::parse(CSVReader& reader) {
-   if (!reader.eol() && (reader.peek() != ",")) {
-      auto token = reader.nextToken();
-      if (auto d = Parser::tryParseDouble(token)) {
-         value = *d;
+bool CSVReader::readRecord(vector<string_view>& fields) {
+   auto trim = [](const char* begin, const char* end) {
+      while (begin != end && (*begin == ' ' || *begin == '\t')) ++begin;
+      while (begin != end && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+      return string_view{begin, static_cast<size_t>(end - begin)};
+   };
+   fields.clear();
+   while (!eof()) {
+      ++line;
+      auto fieldBegin = ptr;
+      // Quoted fields may contain commas and newlines, only unquoted text is trimmed
+      const char* quotedBegin = nullptr;
+      const char* quotedEnd = nullptr;
+      while (true) {
+         auto special = findSpecial(ptr, limit);
+         if (special != limit && *special == '"') {
+            auto close = static_cast<const char*>(memchr(special + 1, '"', limit - special - 1));
+            if (!close) throw runtime_error("csv line " + to_string(line) + " has an unterminated quote");
+            if (!quotedBegin) quotedBegin = special + 1;
+            quotedEnd = close;
+            ptr = close + 1;
+            continue;
+         }
+         if (quotedBegin) {
+            fields.emplace_back(quotedBegin, quotedEnd - quotedBegin);
+         } else {
+            fields.push_back(trim(fieldBegin, special));
+         }
+         quotedBegin = nullptr;
+         if (special == limit) {
+            ptr = limit;
+            break;
+         }
+         ptr = special + 1;
+         if (*special == '\n') break;
+         fieldBegin = ptr;
+      }
+      // Skip empty lines
+      if (fields.size() == 1 && fields[0].empty()) {
+         fields.clear();
+         continue;
       }
+      return true;
+   }
+   return !fields.empty();
+}
+//--------------------------------------------------------------------------------
+CSVValueBase::CSVValueBase(CSVSchema* schema, string_view name) : name{name} {
+   schema->base->registerField(this);
+}
+//--------------------------------------------------------------------------------
+void CSVNumber::parse(string_view field) {
+   if (auto d = Parser::tryParseDouble(field)) {
+      value = *d;
    }
 }
 //--------------------------------------------------------------------------------
@@ -41,19 +117,15 @@ uint64_t CSVNumber::getUInt() const {
    }
 }
 //--------------------------------------------------------------------------------
-void CSVString::parse(CSVReader& reader) {
-   while (!reader.eol() && (reader.peek() != ",")) {
-      value += reader.nextToken();
-   }
+void CSVString::parse(string_view field) {
+   value.assign(field);
 }
 //--------------------------------------------------------------------------------
-void CSVBool::parse(CSVReader& reader) {
-   string token;
-   while (!reader.eol() && (reader.peek() != ",")) {
-      token += reader.nextToken();
-   }
-   transform(token.begin(),token.end(), token.begin(),::tolower);
-   value = (token == "true") || (token == "1");
+void CSVBool::parse(string_view field) {
+   auto equalsIgnoreCase = [](string_view a, string_view b) {
+      return equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) { return Parser::normalizeLetter(x) == y; });
+   };
+   value = equalsIgnoreCase(field, "true") || (field == "1");
 }
 //--------------------------------------------------------------------------------
 }
@@ -1,24 +1,33 @@
 #pragma once
-#include "Parser.hpp"
 #include <cstdint>
+#include <stdexcept>
 #include <string_view>
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 //--------------------------------------------------------------------------------
 namespace infra {
 //--------------------------------------------------------------------------------
-struct CSVReader : public Parser {
-  std::string_view input;
-  CSVReader(std::string_view input) : Parser{input.data(), input.data() + input.size(), false/*nlAsWs*/} {}
+/// Splits the input into records without copying, the fields point into the input
+struct CSVReader {
+  const char* ptr;
+  const char* limit;
+  unsigned line = 0;
+  CSVReader(std::string_view input) : ptr{input.data()}, limit{input.data() + input.size()} {}
 
+  bool eof() const { return ptr == limit; }
+  /// The number of lines, an upper bound for the number of records
+  uint64_t countLines() const;
+  /// Reads the fields of the next non-empty line, quoted fields are returned without their quotes and unquoted fields without surrounding blanks
+  bool readRecord(std::vector<std::string_view>& fields);
+  /// The first comma, quote, or newline in [begin, end), or end
+  static const char* findSpecial(const char* begin, const char* end);
 };
 //--------------------------------------------------------------------------------
 struct CSVValueBase;
 struct CSVBase {
-   std::unordered_map<std::string_view, CSVValueBase*> mapping;
-   void registerField(CSVValueBase* v, std::string_view name) { mapping[name] = v; }
+   /// The fields of the row that is currently constructed, in declaration order
+   std::vector<CSVValueBase*> fields;
+   void registerField(CSVValueBase* v) { fields.push_back(v); }
 };
 struct CSVSchema {
   CSVBase* base;
@@ -26,64 +35,48 @@ struct CSVSchema {
 };
 //--------------------------------------------------------------------------------
 struct CSVValueBase {
-   std::string name;
+   std::string_view name;
    CSVValueBase(CSVSchema* schema, std::string_view name);
 
-   virtual void parse(CSVReader& reader) = 0;
+   virtual void parse(std::string_view field) = 0;
 };
 template <typename T>
 struct CSV : public CSVBase {
    std::vector<T> values;
    void parse(CSVReader& reader) {
-      std::unordered_map<unsigned, std::string> fieldmapping;
-      unsigned fields = 0;
-      while (!reader.eol()) {
-        std::string name;
-        while (!reader.eol() && (reader.peek() != ",")) {
-          name += reader.nextToken();
-        }
-        fieldmapping[fields] = name;
-        if (!reader.eol()) reader.expect(",");
-        ++fields;
-      }
-      auto checkFieldMappings = [&]() {
-         // Check that all mapped fields are actually present
-         std::unordered_set<std::string_view> existingFields;
-         for (auto& f : fieldmapping) {
-            existingFields.insert(f.second);
-         }
-         for (auto& m : mapping) {
-            if (!existingFields.contains(m.first)) {
-               throw std::runtime_error("Mapped field '" + std::string(m.first) + "' is not present in csv file");
+      std::vector<std::string_view> record;
+      if (!reader.readRecord(record)) return;
+      auto columns = record.size();
+
+      // Bind every column to the position of its field in the schema once, so the rows need no lookups by name
+      fields.clear();
+      T prototype{this};
+      std::vector<int> binding(columns, -1);
+      for (unsigned f = 0; f < fields.size(); ++f) {
+         bool found = false;
+         for (unsigned c = 0; c < columns; ++c) {
+            if (record[c] == fields[f]->name) {
+               binding[c] = f;
+               found = true;
             }
          }
-      };
+         if (!found) {
+            throw std::runtime_error("Mapped field '" + std::string(fields[f]->name) + "' is not present in csv file");
+         }
+      }
 
-      bool firstLine = true;
-      reader.advanceLine();
-      while (!reader.eof()) {
-         values.emplace_back(this);
-         if (firstLine) {
-           checkFieldMappings();
-           firstLine = false;
+      values.reserve(values.size() + reader.countLines());
+      while (reader.readRecord(record)) {
+         if (record.size() != columns) {
+            throw std::runtime_error("csv line " + std::to_string(reader.line) + " has " + std::to_string(record.size()) + " fields, expected " + std::to_string(columns));
          }
-         for (unsigned i = 0; i < fields; ++i) {
-            auto fieldname = fieldmapping[i];
-            auto iter = mapping.find(fieldname);
-            if (iter != mapping.end()) {
-              iter->second->parse(reader);
-            } else {
-               // Consume the single token
-               while (!reader.eol() && (reader.peek() != ",")) {
-                  reader.nextToken();
-               }
-            }
-            if ((i + 1) != fields) {
-               reader.expect(",");
-            }
+         fields.clear();
+         values.emplace_back(this);
+         for (unsigned c = 0; c < columns; ++c) {
+            if (binding[c] >= 0) fields[binding[c]]->parse(record[c]);
          }
-         if (!reader.eof()) reader.advanceLine();
       }
+      fields.clear();
    }
 
    auto begin() const { return values.begin(); }
@@ -91,9 +84,9 @@ struct CSV : public CSVBase {
 };
 //--------------------------------------------------------------------------------
 struct CSVNumber : public CSVValueBase {
-   double value;
+   double value = 0;
    CSVNumber(CSVSchema* csv, std::string_view name) : CSVValueBase{csv, name} {}
-   void parse(CSVReader& reader) override;
+   void parse(std::string_view field) override;
    int64_t getInt() const;
    uint64_t getUInt() const;
    bool isInt() const;
@@ -104,14 +97,14 @@ struct CSVNumber : public CSVValueBase {
 struct CSVString : public CSVValueBase {
    std::string value;
    CSVString(CSVSchema* csv, std::string_view name) : CSVValueBase{csv, name} {}
-   void parse(CSVReader& reader) override;
+   void parse(std::string_view field) override;
    const std::string& get() const { return value; }
 };
 //--------------------------------------------------------------------------------
 struct CSVBool : public CSVValueBase {
    bool value = false;
    CSVBool(CSVSchema* csv, std::string_view name) : CSVValueBase{csv, name} {}
-   void parse(CSVReader& reader) override;
+   void parse(std::string_view field) override;
    bool get() const { return value; }
 };
 //--------------------------------------------------------------------------------
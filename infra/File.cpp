@@ -6,6 +6,7 @@
 #include <sys/stat.h>
 #include <sys/uio.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <linux/fs.h>
 //--------------------------------------------------------------------------------
 using namespace std;
@@ -79,6 +80,21 @@ string File::readWholeFile() {
    return result;
 }
 //--------------------------------------------------------------------------------
+MappedFile::MappedFile(const File& file) : length{file.size()} {
+   // An empty file cannot be mapped, but it also has nothing to read
+   if (!length) return;
+   data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file.getFd(), 0);
+   if (data == MAP_FAILED) {
+      data = nullptr;
+      throw std::runtime_error("error mapping file " + file.getFileName() + ": " + getErrorString());
+   }
+   ::madvise(data, length, MADV_SEQUENTIAL);
+}
+//--------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+   if (data) ::munmap(data, length);
+}
+//--------------------------------------------------------------------------------
 bool File::isOpen() const {
    return fileDescriptor != invalidFd;
 }
@@ -76,5 +76,18 @@ class File {
    void checkFileError();
 };
 //--------------------------------------------------------------------------------
+/// Maps the whole file read-only into memory, the contents stay valid while the mapping lives
+class MappedFile {
+   void* data = nullptr;
+   size_t length = 0;
+
+   public:
+   explicit MappedFile(const File& file);
+   MappedFile(const MappedFile& other) = delete;
+   ~MappedFile();
+
+   std::string_view view() const { return {static_cast<const char*>(data), length}; }
+};
+//--------------------------------------------------------------------------------
 }
 //--------------------------------------------------------------------------------
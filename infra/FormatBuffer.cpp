@@ -0,0 +1,61 @@
+#include "FormatBuffer.hpp"
+#include <charconv>
+#include <ostream>
+//--------------------------------------------------------------------------------
+using namespace std;
+//--------------------------------------------------------------------------------
+namespace infra {
+//--------------------------------------------------------------------------------
+void FormatBuffer::flush(ostream& out) {
+   out.write(buffer.data(), buffer.size());
+   buffer.clear();
+}
+//--------------------------------------------------------------------------------
+void FormatBuffer::appendInteger(int64_t value) {
+   char tmp[24];
+   auto [end, ec] = to_chars(tmp, tmp + sizeof(tmp), value);
+   buffer.append(tmp, end);
+}
+//--------------------------------------------------------------------------------
+void FormatBuffer::appendInteger(uint64_t value) {
+   char tmp[24];
+   auto [end, ec] = to_chars(tmp, tmp + sizeof(tmp), value);
+   buffer.append(tmp, end);
+}
+//--------------------------------------------------------------------------------
+FormatBuffer& FormatBuffer::operator<<(double value) {
+   char tmp[32];
+   auto [end, ec] = to_chars(tmp, tmp + sizeof(tmp), value, chars_format::general, 6);
+   buffer.append(tmp, end);
+   return *this;
+}
+//--------------------------------------------------------------------------------
+FormatBuffer& FormatBuffer::appendFixed(double value, int precision) {
+   // Fixed notation of large values needs more digits than fit on the stack
+   char tmp[128];
+   auto [end, ec] = to_chars(tmp, tmp + sizeof(tmp), value, chars_format::fixed, precision);
+   if (ec == errc{}) {
+      buffer.append(tmp, end);
+   } else {
+      string large(400 + precision, '\0');
+      auto [largeEnd, largeEc] = to_chars(large.data(), large.data() + large.size(), value, chars_format::fixed, precision);
+      buffer.append(large.data(), largeEnd);
+   }
+   return *this;
+}
+//--------------------------------------------------------------------------------
+void FormatBuffer::fit(size_t start, size_t width, bool alignLeft) {
+   auto length = buffer.size() - start;
+   if (length > width) {
+      // Like substr(0, width - 2), which keeps everything for tiny widths
+      if (width >= 2) buffer.resize(start + width - 2);
+      buffer += "..";
+   } else if (alignLeft) {
+      buffer.append(width - length, ' ');
+   } else {
+      buffer.insert(start, width - length, ' ');
+   }
+}
+//--------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+#pragma once
+//--------------------------------------------------------------------------------
+#include <concepts>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+//--------------------------------------------------------------------------------
+namespace infra {
+//--------------------------------------------------------------------------------
+/// Formats values into a reusable character buffer with std::to_chars, without the stream state and locale handling of iostreams.
+/// Numbers are formatted like by a default constructed ostream, so both produce the same output.
+class FormatBuffer {
+   std::string buffer;
+
+   public:
+   std::string_view view() const { return buffer; }
+   std::string str() const { return buffer; }
+   size_t size() const { return buffer.size(); }
+   /// Discards the content, but keeps the capacity for the next rows
+   void clear() { buffer.clear(); }
+   /// Writes the content to out and clears the buffer
+   void flush(std::ostream& out);
+
+   FormatBuffer& operator<<(std::string_view s) {
+      buffer.append(s);
+      return *this;
+   }
+   FormatBuffer& operator<<(const char* s) { return *this << std::string_view{s}; }
+   FormatBuffer& operator<<(const std::string& s) { return *this << std::string_view{s}; }
+   FormatBuffer& operator<<(char c) {
+      buffer.push_back(c);
+      return *this;
+   }
+   template <std::integral T>
+      requires(!std::same_as<T, bool> && !std::same_as<T, char>)
+   FormatBuffer& operator<<(T value) {
+      if constexpr (std::is_signed_v<T>) {
+         appendInteger(static_cast<int64_t>(value));
+      } else {
+         appendInteger(static_cast<uint64_t>(value));
+      }
+      return *this;
+   }
+   /// Like the default precision of ostream (%g with 6 significant digits)
+   FormatBuffer& operator<<(double value);
+   /// Like `fixed << setprecision(precision)`
+   FormatBuffer& appendFixed(double value, int precision);
+
+   /// Pads the text appended since start with blanks to width, or cuts it to width - 2 characters followed by "..", when it is too long
+   void fit(size_t start, size_t width, bool alignLeft);
+
+   private:
+   void appendInteger(int64_t value);
+   void appendInteger(uint64_t value);
+};
+//--------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------------------------
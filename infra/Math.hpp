@@ -1,5 +1,6 @@
 #pragma once
 //--------------------------------------------------------------------------------
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
 #include <type_traits>
@@ -36,11 +37,32 @@ inline double roundWithPrecision(double v, unsigned precision) {
   return std::round(v * precision) / precision;
 }
 //---------------------------------------------------------------------------------
-constexpr double getGeneralizedHarmonicNumber(uint64_t n, double m) {
+/// The generalized harmonic number H(n,m) = sum_{k=1}^n k^-m in O(1).
+/// Sums the first terms directly and approximates the tail with the Euler-Maclaurin formula up to the B6 term.
+/// The remainder is bounded by the next term, which keeps the relative error below 1e-12.
+inline double getGeneralizedHarmonicNumber(uint64_t n, double m) {
+  constexpr uint64_t directTerms = 16;
   double result = 0;
-  for (uint64_t k = 1; k <= n; ++k) {
-    result += 1.0 / std::pow(double(k), m);
+  for (uint64_t k = 1; k <= std::min(n, directTerms); ++k) {
+    result += std::pow(double(k), -m);
   }
+  if (n <= directTerms) return result;
+
+  // Tail sum_{k=a}^n f(k) with f(x) = x^-m
+  double a = directTerms + 1;
+  double b = n;
+  auto f = [&](double x) { return std::pow(x, -m); };
+  // Integral of x^-m from a to b, written with expm1 to stay accurate for m close to 1
+  double logRatio = std::log(b / a);
+  double integral = (m == 1.0) ? logRatio : std::pow(a, 1 - m) * std::expm1((1 - m) * logRatio) / (1 - m);
+  // Odd derivatives f^(2j-1)(x) = -m(m+1)...(m+2j-2) x^-(m+2j-1)
+  auto d1 = [&](double x) { return -m * std::pow(x, -m - 1); };
+  auto d3 = [&](double x) { return -m * (m + 1) * (m + 2) * std::pow(x, -m - 3); };
+  auto d5 = [&](double x) { return -m * (m + 1) * (m + 2) * (m + 3) * (m + 4) * std::pow(x, -m - 5); };
+  result += integral + (f(a) + f(b)) / 2;
+  result += (d1(b) - d1(a)) / 12;
+  result -= (d3(b) - d3(a)) / 720;
+  result += (d5(b) - d5(a)) / 30240;
   return result;
 }
 //---------------------------------------------------------------------------------
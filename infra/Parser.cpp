@@ -1,4 +1,5 @@
 #include "Parser.hpp"
+#include <charconv>
 #include <iomanip>
 //--------------------------------------------------------------------------------
 using namespace std;
@@ -54,11 +55,10 @@ void Parser::expect(string_view expected) {
 }
 //--------------------------------------------------------------------------------
 optional<double> Parser::tryParseDouble(string_view str) noexcept {
-   try {
-      return {stod(string{str})};
-   } catch (...) {
-      return {};
-   }
+   double result;
+   auto [end, error] = from_chars(str.data(), str.data() + str.size(), result);
+   if (error != errc{}) return {};
+   return result;
 }
 //--------------------------------------------------------------------------------
 string_view Parser::nextToken() {
@@ -125,7 +125,7 @@ template <uint64_t mag>
 bool UnitInterpreter<mag>::machineReadable = false;
 //--------------------------------------------------------------------------------
 template <uint64_t mag>
-void UnitInterpreter<mag>::print(ostream& out, const uint64_t& val) {
+void UnitInterpreter<mag>::print(FormatBuffer& out, uint64_t val) {
    if (machineReadable) {
       out << val;
       return;
@@ -141,15 +141,20 @@ void UnitInterpreter<mag>::print(ostream& out, const uint64_t& val) {
 
    double result = (double)val/finalDivisor;
    assert(orders <= 6);
-   stringstream ss;
    int64_t result_int = result;
    if (result_int == result) {
-      ss << result_int;
+      out << result_int;
    } else {
-      ss << std::fixed << std::setprecision(1) << result;
+      out.appendFixed(result, 1);
    }
-   if (orders != 0) ss << units[orders];
-   out << ss.str();
+   if (orders != 0) out << units[orders];
+}
+//--------------------------------------------------------------------------------
+template <uint64_t mag>
+void UnitInterpreter<mag>::print(ostream& out, const uint64_t& val) {
+   FormatBuffer buffer;
+   print(buffer, val);
+   out << buffer.view();
 }
 //--------------------------------------------------------------------------------
 template struct UnitInterpreter<1024>;
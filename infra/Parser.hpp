@@ -1,5 +1,6 @@
 #pragma once
 //--------------------------------------------------------------------------------
+#include "FormatBuffer.hpp"
 #include <string_view>
 #include <cassert>
 #include <cstring>
@@ -72,9 +73,10 @@ struct UnitInterpreter {
    static constexpr uint64_t magnitude = mag;
    static constexpr char units[] = {' ','k','m','g','t','p','e'};
    static bool parse(const char* str,uint64_t& val);
+   static void print(FormatBuffer& out, uint64_t val);
    static void print(std::ostream& out, const uint64_t& val);
    static std::string print(uint64_t val) {
-      std::stringstream str;
+      FormatBuffer str;
       print(str,val);
       return str.str();
    }
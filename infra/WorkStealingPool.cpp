@@ -0,0 +1,73 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <thread>
+//--------------------------------------------------------------------------------
+using namespace std;
+//--------------------------------------------------------------------------------
+namespace infra {
+//--------------------------------------------------------------------------------
+optional<uint64_t> WorkStealingPool::popFront(Worker& w) {
+   lock_guard lock{w.mutex};
+   if (w.tasks.empty()) return nullopt;
+   auto task = w.tasks.front();
+   w.tasks.pop_front();
+   return task;
+}
+//--------------------------------------------------------------------------------
+optional<uint64_t> WorkStealingPool::popBack(Worker& w) {
+   lock_guard lock{w.mutex};
+   if (w.tasks.empty()) return nullopt;
+   auto task = w.tasks.back();
+   w.tasks.pop_back();
+   return task;
+}
+//--------------------------------------------------------------------------------
+void WorkStealingPool::run(uint64_t numTasks, const function<void(uint64_t)>& fn) {
+   auto numWorkers = static_cast<unsigned>(min<uint64_t>(threads, numTasks));
+   if (numWorkers <= 1) {
+      for (uint64_t t = 0; t < numTasks; ++t) fn(t);
+      return;
+   }
+
+   // Give every worker a contiguous range, so neighbouring tasks usually run on the same thread
+   vector<Worker> workers(numWorkers);
+   for (unsigned w = 0; w < numWorkers; ++w) {
+      for (uint64_t t = numTasks * w / numWorkers; t < numTasks * (w + 1) / numWorkers; ++t) {
+         workers[w].tasks.push_back(t);
+      }
+   }
+
+   mutex errorMutex;
+   exception_ptr error;
+   auto work = [&](unsigned self) {
+      auto next = [&]() -> optional<uint64_t> {
+         if (auto task = popFront(workers[self])) return task;
+         for (unsigned i = 1; i < numWorkers; ++i) {
+            if (auto task = popBack(workers[(self + i) % numWorkers])) return task;
+         }
+         return nullopt;
+      };
+      // Tasks never spawn new tasks, so once all deques are empty we are done
+      while (auto task = next()) {
+         try {
+            fn(*task);
+         } catch (...) {
+            lock_guard lock{errorMutex};
+            if (!error) error = current_exception();
+         }
+      }
+   };
+
+   vector<thread> pool;
+   pool.reserve(numWorkers - 1);
+   for (unsigned w = 1; w < numWorkers; ++w) {
+      pool.emplace_back(work, w);
+   }
+   work(0);
+   for (auto& t : pool) t.join();
+   if (error) rethrow_exception(error);
+}
+//--------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------------------------
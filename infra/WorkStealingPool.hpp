@@ -0,0 +1,35 @@
+#pragma once
+//--------------------------------------------------------------------------------
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace infra {
+//--------------------------------------------------------------------------------
+/// Runs a batch of independent tasks on a fixed number of threads.
+/// Each worker starts with a contiguous range of task ids in its own deque, pops from the front of it,
+/// and steals from the back of the other deques once it runs dry.
+class WorkStealingPool {
+   struct Worker {
+      std::mutex mutex;
+      std::deque<uint64_t> tasks;
+   };
+   unsigned threads;
+
+   static std::optional<uint64_t> popFront(Worker& w);
+   static std::optional<uint64_t> popBack(Worker& w);
+
+   public:
+   explicit WorkStealingPool(unsigned threads) : threads{threads ? threads : 1} {}
+   unsigned getThreads() const { return threads; }
+
+   /// Calls fn(task) for every task in [0, numTasks) and blocks until all of them are done.
+   /// The first exception thrown by a task is rethrown to the caller.
+   void run(uint64_t numTasks, const std::function<void(uint64_t task)>& fn);
+};
+//--------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------------------------